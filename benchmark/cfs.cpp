@@ -1,9 +1,38 @@
 #include "cfs/cfs_utility.h"
+#include "cfs/perf_counters.h"
 
 #include <junk/algorithm/cfs.h>
+#include <zoo/algorithm/cfsAggregate.h>
+#include <zoo/algorithm/cfsColumns.h>
+#include <zoo/algorithm/cfsParallel.h>
+#include <zoo/algorithm/cfsSetOperations.h>
+#include <zoo/algorithm/karyCFS.h>
 #include <zoo/algorithm/quicksort.h>
+#include <zoo/algorithm/veb.h>
+#include <zoo/BlockedBloomFilter.h>
+#include <zoo/CfsIndex.h>
+#include <zoo/CfsMap.h>
+#include <zoo/CfsSet.h>
+#include <zoo/CfsSnapshotHandle.h>
+#include <zoo/CfsStringIndex.h>
+#include <zoo/DaryHeap.h>
+#include <zoo/DeduplicatedCFS.h>
+#include <zoo/FlatHashSet.h>
+#include <zoo/HugePageAllocator.h>
+#include <zoo/LearnedIndex.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <random>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -22,6 +51,47 @@ void transformationToCFS(benchmark::State &s) {
     s.SetComplexityN(n);
 }
 
+/// Restoring the sorted order is excluded from the measurement
+void transformationToCFSInPlace(benchmark::State &s) {
+    auto n = s.range(0);
+    auto lin = linear_vector(n - 1);
+    auto converted = lin;
+    for(auto _: s) {
+        zoo::transformToCFSInPlace(begin(converted), end(converted));
+        benchmark::DoNotOptimize(converted.data());
+        s.PauseTiming();
+        std::copy(cbegin(lin), cend(lin), begin(converted));
+        s.ResumeTiming();
+    }
+    s.SetComplexityN(n);
+}
+
+/// Arguments: the size and the number of threads
+void transformationToCFSParallel(benchmark::State &s) {
+    auto n = s.range(0);
+    auto threads = s.range(1);
+    auto lin = linear_vector(n - 1);
+    std::vector<int> converted(lin.size());
+    for(auto _: s) {
+        benchmark::DoNotOptimize(lin.data());
+        zoo::transformToCFSParallel(
+            converted.begin(), cbegin(lin), cend(lin), threads
+        );
+        benchmark::DoNotOptimize(converted.data());
+    }
+    s.SetComplexityN(n);
+}
+
+void parallelArguments(benchmark::internal::Benchmark *b) {
+    int cores = std::thread::hardware_concurrency();
+    for(auto size = RangeLow; size <= RangeHigh; size *= 10) {
+        for(auto threads = 1; threads < cores; threads *= 2) {
+            b->Args({size, threads});
+        }
+        b->Args({size, std::max(cores, 1)});
+    }
+}
+
 void genLinearVector(benchmark::State &s) {
     auto n = s.range(0);
     for(auto _: s) {
@@ -52,6 +122,35 @@ void sortSTLRandomVector(benchmark::State &s) {
     s.SetComplexityN(n);
 }
 
+void sortThenTransformToCFS(benchmark::State &s) {
+    auto n = s.range(0);
+    auto v = makeRandomVector(n);
+    std::vector<int> converted;
+    converted.reserve(n);
+    for(auto _: s) {
+        benchmark::DoNotOptimize(v.data());
+        auto copy = v;
+        std::sort(begin(copy), end(copy));
+        zoo::transformToCFS(back_inserter(converted), cbegin(copy), cend(copy));
+        benchmark::DoNotOptimize(converted.data());
+        converted.clear();
+    }
+    s.SetComplexityN(n);
+}
+
+void sortToCFS(benchmark::State &s) {
+    auto n = s.range(0);
+    auto v = makeRandomVector(n);
+    std::vector<int> converted(n);
+    for(auto _: s) {
+        benchmark::DoNotOptimize(v.data());
+        auto copy = v;
+        zoo::sortToCFS(begin(copy), end(copy), begin(converted));
+        benchmark::DoNotOptimize(converted.data());
+    }
+    s.SetComplexityN(n);
+}
+
 void justARandomKeyCallingOpaque(benchmark::State &s) {
     for(auto _: s) {
         randomTwo30();
@@ -117,10 +216,32 @@ struct UseUnordered;
 template<>
 struct PolicyWrapper<UseUnordered>;
 
-template<typename F>
-void search(benchmark::State &s) {
-    auto n = s.range(0);
+/// Counters of the search structure, as its bytes, reported only for the
+/// spaces for which they are meaningful
+template<typename Spc>
+void reportSpace(benchmark::State &, const Spc &) {}
+
+template<typename T, typename A>
+void reportSpace(benchmark::State &s, const std::vector<T, A> &space) {
+    s.counters["bytes"] = space.size() * sizeof(T);
+}
+
+template<typename T>
+void reportSpace(benchmark::State &s, const zoo::LearnedIndex<T> &space) {
+    s.counters["bytes"] = space.size() * sizeof(T) + space.modelBytes();
+    s.counters["modelBytes"] = space.modelBytes();
+    s.counters["segments"] = space.segments();
+}
+
+template<typename T>
+void reportSpace(benchmark::State &s, const zoo::FlatHashSet<T> &space) {
+    s.counters["bytes"] = space.capacity() * (sizeof(T) + 1);
+}
 
+/// The spaces are expensive to build, they are kept for all the benchmarks
+/// of the same space policy and size
+template<typename F>
+auto &spaceFor(int n) {
     using SpaceType = decltype(F::makeSpace(n));
 
     static std::unordered_map<int, SpaceType> spaces;
@@ -128,12 +249,43 @@ void search(benchmark::State &s) {
     if(spaces.end() == where) {
         where = spaces.insert({n, F::makeSpace(n)}).first;
     }
-    auto &space = where->second;
-    auto b{cbegin(space)}, e{cend(space)};
+    return where->second;
+}
+
+/// Reports the misses per query of the valid counters, or labels the
+/// benchmark if there are none
+void reportMisses(
+    benchmark::State &s, const PerfCounters &counters, double queries
+) {
+    if(!counters.anyValid()) {
+        s.SetLabel("no perf counters");
+        return;
+    }
+    for(auto e = 0; e < PerfCounters::EventCount; ++e) {
+        auto event = PerfCounters::Event(e);
+        if(counters.valid(event)) {
+            s.counters[PerfCounters::name(event)] =
+                counters.read(event) / queries;
+        }
+    }
+}
+
+/// \tparam CountMisses reports the L1D, LLC and dTLB misses per query
+template<typename F, bool CountMisses = false>
+void search(benchmark::State &s) {
+    auto n = s.range(0);
+    auto &space = spaceFor<F>(n);
+    auto b{std::cbegin(space)}, e{std::cend(space)};
     constexpr auto mask = (1 << 20) - 1;
     auto keys = makeRandomVector(mask + 1, 2*n);
     auto kNdx = 0;
     auto ultimate = 0, found = 0, searched = 0;
+    // opening the counters costs system calls, only when they are reported
+    std::optional<PerfCounters> counters;
+    if constexpr(CountMisses) {
+        counters.emplace();
+        counters->start();
+    }
     for(auto _: s) {
         auto k = keys[kNdx++];
         ++searched;
@@ -145,8 +297,47 @@ void search(benchmark::State &s) {
         benchmark::DoNotOptimize(r);
         kNdx &= mask;
     }
+    if constexpr(CountMisses) {
+        counters->stop();
+        reportMisses(s, *counters, searched);
+    }
+    s.counters["ultimate"] = ultimate;
+    s.counters["ratio"] = searched/double(found);
+    reportSpace(s, space);
+    s.SetItemsProcessed(searched);
+    s.SetComplexityN(n);
+}
+
+/// Searches \c Batch keys per iteration with \c cfsLowerBoundBatch,
+/// the items processed are comparable to those of \c search
+template<typename F, int Batch = 1024>
+void searchBatch(benchmark::State &s) {
+    auto n = s.range(0);
+    auto &space = spaceFor<F>(n);
+    auto b{std::cbegin(space)}, e{std::cend(space)};
+    constexpr auto mask = (1 << 20) - 1;
+    static_assert(0 == (mask + 1) % Batch);
+    auto keys = makeRandomVector(mask + 1, 2*n);
+    std::vector<decltype(b)> results(Batch);
+    auto kNdx = 0;
+    auto ultimate = 0, found = 0, searched = 0;
+    for(auto _: s) {
+        auto keysBegin = keys.cbegin() + kNdx;
+        F::searchBatch(b, e, keysBegin, keysBegin + Batch, results.begin());
+        for(auto r: results) {
+            auto k = *keysBegin++;
+            if(e != r && k == *r) {
+                ++found;
+                ultimate ^= asInt(*r);
+            }
+        }
+        benchmark::DoNotOptimize(results.data());
+        searched += Batch;
+        kNdx = (kNdx + Batch) & mask;
+    }
     s.counters["ultimate"] = ultimate;
     s.counters["ratio"] = searched/double(found);
+    s.SetItemsProcessed(searched);
     s.SetComplexityN(n);
 }
 
@@ -194,6 +385,55 @@ struct UseCFSLowerBound {
     }
 };
 
+struct UseCFSLowerBoundBatch: UseCFSLowerBound {
+    template<typename I, typename KI, typename O>
+    static auto searchBatch(I b, I e, KI kb, KI ke, O out) {
+        return zoo::cfsLowerBoundBatch(b, e, kb, ke, out);
+    }
+};
+
+template<int PrefetchDistance>
+struct UseCFSBranchFree: UseCFSLowerBound {
+    template<typename I, typename E>
+    static auto search(I b, I e, const E &v) {
+        using Policy = zoo::BranchFree<PrefetchDistance>;
+        return zoo::cfsLowerBound(Policy{}, b, e, v);
+    }
+};
+
+struct UseKaryCFS {
+    static auto makeSpace(int q) {
+        auto raw = makeRandomVector(q);
+        auto b{begin(raw)}, e{end(raw)};
+        std::sort(b, e);
+        constexpr auto KeysPerNode = zoo::KaryKeysPerNode<int>;
+        CacheAlignedVector<int> rv(zoo::karyCFSSize<KeysPerNode>(q));
+        zoo::transformToKaryCFS(rv.begin(), b, e);
+        return rv;
+    }
+
+    template<typename I, typename E>
+    static auto search(I b, I e, const E &v) {
+        return zoo::karyLowerBound(b, e, v);
+    }
+};
+
+struct UseVEB {
+    static auto makeSpace(int q) {
+        auto raw = makeRandomVector(q);
+        auto b{begin(raw)}, e{end(raw)};
+        std::sort(b, e);
+        CacheAlignedVector<int> rv(zoo::vebSize(q));
+        zoo::transformToVEB(rv.begin(), b, e);
+        return rv;
+    }
+
+    template<typename I, typename E>
+    static auto search(I b, I e, const E &v) {
+        return zoo::vebLowerBound(b, e, v);
+    }
+};
+
 struct UseCFSSearch: UseCFSLowerBound {
     template<typename I, typename E>
     static auto search(I b, I e, const E &v) {
@@ -208,10 +448,144 @@ struct UseCFSLBOld: UseCFSLowerBound {
     }
 };
 
+template<typename T>
+using HugePageVector = std::vector<T, zoo::HugePageAllocator<T>>;
+
+struct UseSTLHugePages: UseSTL {
+    static auto makeSpace(int q) {
+        auto sorted = UseSTL::makeSpace(q);
+        return HugePageVector<int>(sorted.begin(), sorted.end());
+    }
+};
+
+struct UseCFSLowerBoundHugePages: UseCFSLowerBound {
+    static auto makeSpace(int q) {
+        auto cfs = UseCFSLowerBound::makeSpace(q);
+        return HugePageVector<int>(cfs.begin(), cfs.end());
+    }
+};
+
+void searchSTLHugePages(benchmark::State &s) {
+    search<UseSTLHugePages>(s);
+}
+
+void searchCFSLowerBoundHugePages(benchmark::State &s) {
+    search<UseCFSLowerBoundHugePages>(s);
+}
+
 void searchCFSLowerBound(benchmark::State &s) {
     search<UseCFSLowerBound>(s);
 }
 
+/// Sorted keys with a piecewise linear model of their positions, the
+/// random keys are near uniform, the best case of the model
+struct UseLearnedIndex {
+    static auto makeSpace(int q) {
+        auto sorted = UseSTL::makeSpace(q);
+        return zoo::LearnedIndex<int>(sorted.begin(), sorted.end());
+    }
+};
+template<>
+struct PolicyWrapper<UseLearnedIndex> {
+    template<typename I>
+    static auto search(I, I, int v, const zoo::LearnedIndex<int> &s) {
+        return s.lowerBound(v);
+    }
+};
+
+void searchLearnedIndex(benchmark::State &s) {
+    search<UseLearnedIndex>(s);
+}
+
+/// The CFS array behind a Bloom filter built with it, the searches of the
+/// keys the filter rejects are skipped
+struct CfsWithBloom {
+    std::vector<int> cfs;
+    zoo::BlockedBloomFilter<int> filter;
+    /// Tallied by the searches for the rate of false positives
+    mutable long rejected = 0, falsePositives = 0;
+
+    auto begin() const { return cfs.begin(); }
+    auto end() const { return cfs.end(); }
+};
+
+void reportSpace(benchmark::State &s, const CfsWithBloom &space) {
+    s.counters["bytes"] =
+        space.cfs.size() * sizeof(int) + space.filter.bytes();
+    auto negatives = space.rejected + space.falsePositives;
+    s.counters["falsePositiveRate"] =
+        negatives ? space.falsePositives / double(negatives) : 0;
+    space.rejected = space.falsePositives = 0;
+}
+
+struct UseCFSBloom {
+    static auto makeSpace(int q) {
+        auto cfs = UseCFSLowerBound::makeSpace(q);
+        zoo::BlockedBloomFilter<int> filter(cfs.begin(), cfs.end());
+        return CfsWithBloom{std::move(cfs), std::move(filter)};
+    }
+};
+template<>
+struct PolicyWrapper<UseCFSBloom> {
+    template<typename I>
+    static auto search(I b, I e, int v, const CfsWithBloom &s) {
+        if(not s.filter.mayContain(v)) {
+            ++s.rejected;
+            return e;
+        }
+        auto rv = zoo::cfsLowerBound(b, e, v);
+        if(e == rv || v != *rv) { ++s.falsePositives; }
+        return rv;
+    }
+};
+
+void searchCFSBloom(benchmark::State &s) {
+    search<UseCFSBloom>(s);
+}
+
+void searchCFSLowerBoundBatch(benchmark::State &s) {
+    searchBatch<UseCFSLowerBoundBatch>(s);
+}
+
+void searchCFSBranchFree(benchmark::State &s) {
+    search<UseCFSBranchFree<4>>(s);
+}
+
+void searchCFSBranchFreeNoPrefetch(benchmark::State &s) {
+    search<UseCFSBranchFree<0>>(s);
+}
+
+/// The one-based layout in cache line aligned storage
+template<typename Policy>
+struct UseCfsIndex {
+    static auto makeSpace(int q) {
+        auto raw = makeRandomVector(q);
+        std::sort(begin(raw), end(raw));
+        return zoo::CfsIndex<int>(raw.cbegin(), raw.cend());
+    }
+
+    template<typename I, typename E>
+    static auto search(I b, I e, const E &v) {
+        return zoo::cfsLowerBound(Policy{}, b, e, v);
+    }
+};
+
+void searchCfsIndex(benchmark::State &s) {
+    search<UseCfsIndex<zoo::Branching>>(s);
+}
+
+void searchCfsIndexBranchFree(benchmark::State &s) {
+    search<UseCfsIndex<zoo::BranchFree<4>>>(s);
+}
+
+void searchKaryCFS(benchmark::State &s) {
+    search<UseKaryCFS>(s);
+}
+
+void searchVEB(benchmark::State &s) {
+    search<UseVEB>(s);
+}
+
 void searchCFSEarly(benchmark::State &s) {
     search<UseCFSSearch>(s);
 }
@@ -249,14 +623,10 @@ struct UseCacheLineSTL: UseSTL {
 struct UseCacheLineCFS: UseCFSLowerBound {
     static auto makeSpace(int q) {
         auto sorted = makeSortedCacheLineSpace(q);
-        std::vector<CacheLine> rv;
-        rv.reserve(q);
-        zoo::transformToCFS(back_inserter(rv), sorted.cbegin(), sorted.cend());
-        if(!zoo::validHeap(rv)) {
+        zoo::CfsIndex<CacheLine> rv(sorted.cbegin(), sorted.cend());
+        if(!zoo::validHeap(rv.begin(), rv.end())) {
             throw 0;
         }
-        auto l = reinterpret_cast<long>(rv.data());
-        if(l % 64) { throw; }
         return rv;
     }
 };
@@ -269,6 +639,67 @@ void searchCacheLineCFS(benchmark::State &s) {
     search<UseCacheLineCFS>(s);
 }
 
+/// The keys apart from the records, the record is loaded only when found
+struct UseCacheLineCfsMap {
+    static auto makeSpace(int q) {
+        auto sorted = makeSortedCacheLineSpace(q);
+        std::vector<int> keys;
+        keys.reserve(q);
+        for(auto &record: sorted) { keys.push_back(record.value); }
+        return zoo::CfsMap<int, CacheLine>(
+            keys.begin(), keys.end(), sorted.begin()
+        );
+    }
+};
+template<>
+struct PolicyWrapper<UseCacheLineCfsMap> {
+    template<typename I, typename Space>
+    static auto search(I b, I, int v, const Space &s) {
+        auto ndx = s.lowerBound(v);
+        if(s.size() != ndx && v == s.key(ndx)) {
+            benchmark::DoNotOptimize(s.value(ndx).space[1]);
+        }
+        return b + ndx;
+    }
+};
+
+void searchCacheLineCfsMap(benchmark::State &s) {
+    search<UseCacheLineCfsMap>(s);
+}
+
+/// The memory hierarchy sweep: working sets around each of the cache
+/// boundaries, with the misses per query
+template<std::size_t ElementSize>
+void cacheSweepArguments(benchmark::internal::Benchmark *b) {
+    for(auto n: cacheSweepSizes(ElementSize, RangeHigh * sizeof(int))) {
+        b->Arg(n);
+    }
+}
+
+void sweepSTL(benchmark::State &s) {
+    search<UseSTL, true>(s);
+}
+
+void sweepCFSLowerBound(benchmark::State &s) {
+    search<UseCFSLowerBound, true>(s);
+}
+
+void sweepCFSEarly(benchmark::State &s) {
+    search<UseCFSSearch, true>(s);
+}
+
+void sweepCacheLineSTL(benchmark::State &s) {
+    search<UseCacheLineSTL, true>(s);
+}
+
+void sweepCacheLineCFS(benchmark::State &s) {
+    search<UseCacheLineCFS, true>(s);
+}
+
+void sweepCacheLineCfsMap(benchmark::State &s) {
+    search<UseCacheLineCfsMap, true>(s);
+}
+
 struct UseOnordered {
     static auto makeSpace(int q) {
         std::vector<int> raw{makeRandomVector(q)};
@@ -291,12 +722,623 @@ void searchUnordered(benchmark::State &s) {
     search<UseOnordered>(s);
 }
 
+struct UseFlatHashSet {
+    static auto makeSpace(int q) {
+        auto raw = makeRandomVector(q);
+        return zoo::FlatHashSet<int>(raw.begin(), raw.end());
+    }
+};
+template<>
+struct PolicyWrapper<UseFlatHashSet> {
+    template<typename I>
+    static auto search(I, I, int v, const zoo::FlatHashSet<int> &s) {
+        return s.find(v);
+    }
+};
+
+void searchFlatHashSet(benchmark::State &s) {
+    search<UseFlatHashSet>(s);
+}
+
+/// Arguments: the size and how many operations in 1024 are updates,
+/// half insertions and half erasures, the rest are lookups
+template<typename Set>
+void mixedWorkload(benchmark::State &s) {
+    auto n = s.range(0);
+    auto updatesPer1024 = s.range(1);
+    auto initial = makeRandomVector(n, 2*n);
+    Set set(initial.begin(), initial.end());
+    constexpr auto mask = (1 << 20) - 1;
+    auto keys = makeRandomVector(mask + 1, 2*n);
+    auto kNdx = 0;
+    auto found = 0;
+    for(auto _: s) {
+        auto k = keys[kNdx];
+        auto kind = kNdx & 1023;
+        if(kind < updatesPer1024) {
+            if(kind & 1) { set.insert(k); }
+            else { set.erase(k); }
+        } else {
+            found += set.contains(k);
+        }
+        kNdx = (kNdx + 1) & mask;
+    }
+    benchmark::DoNotOptimize(found);
+    s.SetItemsProcessed(s.iterations());
+    s.SetComplexityN(n);
+}
+
+struct STLSet: std::set<int> {
+    using std::set<int>::set;
+    bool contains(int k) const { return end() != find(k); }
+};
+
+void mixedCfsSet(benchmark::State &s) {
+    mixedWorkload<zoo::CfsSet<int>>(s);
+}
+
+void mixedSTLSet(benchmark::State &s) {
+    mixedWorkload<STLSet>(s);
+}
+
+void mixedArguments(benchmark::internal::Benchmark *b) {
+    for(auto size = RangeLow; size <= RangeHigh / 10; size *= 10) {
+        for(auto updates: {0, 10, 100}) {
+            b->Args({size, updates});
+        }
+    }
+}
+
+/// The priority queue as a timer queue in steady state: of \c n pending
+/// deadlines, the earliest expires and a later one is scheduled; with
+/// delays up to 2n the earliest deadline advances about 1 per operation,
+/// which keeps the deadlines far from overflowing
+template<typename Queue>
+void holdPriorityQueue(benchmark::State &s) {
+    auto n = s.range(0);
+    auto initial = makeRandomVector(n, 2*n);
+    Queue queue(initial.begin(), initial.end());
+    constexpr auto mask = (1 << 16) - 1;
+    auto delays = makeRandomVector(mask + 1, 2*n);
+    auto dNdx = 0;
+    long expired = 0;
+    for(auto _: s) {
+        auto now = queue.top();
+        queue.pop();
+        queue.push(now + delays[dNdx++]);
+        dNdx &= mask;
+        expired += now;
+    }
+    benchmark::DoNotOptimize(expired);
+    s.SetItemsProcessed(s.iterations());
+}
+
+/// Building the priority queue from \c n elements at once
+template<typename Queue>
+void heapifyPriorityQueue(benchmark::State &s) {
+    auto n = s.range(0);
+    auto values = makeRandomVector(n, RangeHigh);
+    for(auto _: s) {
+        Queue queue(values.begin(), values.end());
+        benchmark::DoNotOptimize(queue.top());
+    }
+    s.SetItemsProcessed(s.iterations() * n);
+}
+
+using STLMinimumQueue =
+    std::priority_queue<int, std::vector<int>, std::greater<int>>;
+
+void holdSTLPriorityQueue(benchmark::State &s) {
+    holdPriorityQueue<STLMinimumQueue>(s);
+}
+
+void holdDaryHeap(benchmark::State &s) {
+    holdPriorityQueue<zoo::DaryHeap<int>>(s);
+}
+
+void holdDaryHeap4(benchmark::State &s) {
+    holdPriorityQueue<zoo::DaryHeap<int, 4>>(s);
+}
+
+void heapifySTLPriorityQueue(benchmark::State &s) {
+    heapifyPriorityQueue<STLMinimumQueue>(s);
+}
+
+void heapifyDaryHeap(benchmark::State &s) {
+    heapifyPriorityQueue<zoo::DaryHeap<int>>(s);
+}
+
+/// Rows indexed by (tenant, timestamp), with a payload of the size of
+/// the unrelated fields of a record
+struct TenantRow {
+    int tenant;
+    long timestamp;
+    char payload[48];
+};
+
+std::vector<TenantRow> makeSortedTenantRows(int n) {
+    std::mt19937 generator;
+    std::uniform_int_distribution<int> tenants(0, 999);
+    std::uniform_int_distribution<long> times(0, 1l << 40);
+    std::vector<TenantRow> rv(n);
+    for(auto &row: rv) {
+        row.tenant = tenants(generator);
+        row.timestamp = times(generator);
+    }
+    std::sort(
+        rv.begin(), rv.end(),
+        [](auto &l, auto &r) {
+            return
+                l.tenant < r.tenant ||
+                (l.tenant == r.tenant && l.timestamp < r.timestamp);
+        }
+    );
+    return rv;
+}
+
+struct TenantRowLess {
+    using Key = std::tuple<int, long>;
+
+    bool operator()(const TenantRow &row, const Key &k) const {
+        return std::make_tuple(row.tenant, row.timestamp) < k;
+    }
+
+    bool operator()(const Key &k, const TenantRow &row) const {
+        return k < std::make_tuple(row.tenant, row.timestamp);
+    }
+};
+
+auto makeTenantKeys(int count) {
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<int> tenants(0, 999);
+    std::uniform_int_distribution<long> times(0, 1l << 40);
+    std::vector<std::tuple<int, long>> rv;
+    for(auto ndx = count; ndx--; ) {
+        rv.emplace_back(tenants(generator), times(generator));
+    }
+    return rv;
+}
+
+/// Composite key lookups in a CFS array of rows
+void searchCompositeRowsCFS(benchmark::State &s) {
+    auto n = s.range(0);
+    auto sorted = makeSortedTenantRows(n);
+    std::vector<TenantRow> cfs;
+    zoo::transformToCFS(back_inserter(cfs), sorted.begin(), sorted.end());
+    constexpr auto mask = (1 << 16) - 1;
+    auto keys = makeTenantKeys(mask + 1);
+    auto kNdx = 0;
+    long found = 0;
+    for(auto _: s) {
+        auto where =
+            zoo::cfsLowerBound(
+                cfs.cbegin(), cfs.cend(), keys[kNdx++], TenantRowLess{}
+            );
+        found += where - cfs.cbegin();
+        kNdx &= mask;
+    }
+    benchmark::DoNotOptimize(found);
+    s.SetItemsProcessed(s.iterations());
+}
+
+/// The same lookups in CFS columns of the tenants and the timestamps
+void searchCompositeColumnsCFS(benchmark::State &s) {
+    auto n = s.range(0);
+    std::vector<int> tenants;
+    std::vector<long> timestamps;
+    {
+        auto sorted = makeSortedTenantRows(n);
+        std::vector<int> sortedTenants;
+        std::vector<long> sortedTimestamps;
+        for(auto &row: sorted) {
+            sortedTenants.push_back(row.tenant);
+            sortedTimestamps.push_back(row.timestamp);
+        }
+        tenants.resize(n);
+        timestamps.resize(n);
+        zoo::transformColumnsToCFS(
+            std::make_tuple(tenants.begin(), timestamps.begin()),
+            std::make_tuple(sortedTenants.cbegin(), sortedTimestamps.cbegin()),
+            n
+        );
+    }
+    auto columns = std::make_tuple(tenants.cbegin(), timestamps.cbegin());
+    constexpr auto mask = (1 << 16) - 1;
+    auto keys = makeTenantKeys(mask + 1);
+    auto kNdx = 0;
+    long found = 0;
+    for(auto _: s) {
+        found += zoo::cfsLowerBound(columns, n, keys[kNdx++]);
+        kNdx &= mask;
+    }
+    benchmark::DoNotOptimize(found);
+    s.SetItemsProcessed(s.iterations());
+}
+
+/// A CFS index republished by a writer thread through a
+/// \c zoo::CfsSnapshotHandle, each reader uses the slot of its thread index
+struct SnapshotPublishedCFS {
+    std::vector<int> sorted;
+    zoo::CfsSnapshotHandle<std::vector<int>> handle;
+
+    SnapshotPublishedCFS(std::vector<int> s, int readers):
+        sorted(std::move(s)), handle(readers, makeVersion())
+    {}
+
+    std::unique_ptr<std::vector<int>> makeVersion() const {
+        auto rv = std::make_unique<std::vector<int>>();
+        zoo::transformToCFS(back_inserter(*rv), sorted.begin(), sorted.end());
+        return rv;
+    }
+
+    void republish() { handle.publish(makeVersion()); }
+
+    bool contains(int reader, int k) const {
+        auto version = handle.acquire(reader);
+        auto e = version->cend();
+        auto where = zoo::cfsLowerBound(version->cbegin(), e, k);
+        return e != where && k == *where;
+    }
+};
+
+/// The same, guarded by a reader-writer lock
+struct LockPublishedCFS {
+    std::vector<int> sorted;
+    mutable std::shared_mutex mutex;
+    std::unique_ptr<std::vector<int>> version;
+
+    LockPublishedCFS(std::vector<int> s, int):
+        sorted(std::move(s)), version(makeVersion())
+    {}
+
+    std::unique_ptr<std::vector<int>> makeVersion() const {
+        auto rv = std::make_unique<std::vector<int>>();
+        zoo::transformToCFS(back_inserter(*rv), sorted.begin(), sorted.end());
+        return rv;
+    }
+
+    void republish() {
+        auto next = makeVersion();
+        std::unique_lock<std::shared_mutex> exclusive(mutex);
+        version.swap(next);
+    }
+
+    bool contains(int, int k) const {
+        std::shared_lock<std::shared_mutex> shared(mutex);
+        auto e = version->cend();
+        auto where = zoo::cfsLowerBound(version->cbegin(), e, k);
+        return e != where && k == *where;
+    }
+};
+
+/// Lookups from every benchmark thread while a writer thread republishes
+/// the index every 100 microseconds
+///
+/// The random generator is not thread safe: the first thread makes both
+/// the index and the keys before the loops start, then every reader walks
+/// the shared keys from its own offset
+template<typename Published>
+void searchWhileRepublishing(benchmark::State &s) {
+    constexpr auto mask = (1 << 16) - 1;
+    static std::unique_ptr<Published> published;
+    static std::vector<int> keys;
+    static std::atomic<bool> done;
+    static std::thread writer;
+    auto n = s.range(0);
+    if(0 == s.thread_index()) {
+        auto sorted = makeRandomVector(n, 2*n);
+        std::sort(sorted.begin(), sorted.end());
+        keys = makeRandomVector(mask + 1, 2*n);
+        published = std::make_unique<Published>(sorted, s.threads());
+        done = false;
+        writer = std::thread([]() {
+            while(!done) {
+                published->republish();
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+    }
+    auto reader = s.thread_index();
+    auto kNdx = reader * 4099 & mask;
+    auto found = 0;
+    for(auto _: s) {
+        found += published->contains(reader, keys[kNdx++]);
+        kNdx &= mask;
+    }
+    benchmark::DoNotOptimize(found);
+    s.SetItemsProcessed(s.iterations());
+    if(0 == s.thread_index()) {
+        done = true;
+        writer.join();
+        published.reset();
+    }
+}
+
+void searchSnapshotPublished(benchmark::State &s) {
+    searchWhileRepublishing<SnapshotPublishedCFS>(s);
+}
+
+void searchLockPublished(benchmark::State &s) {
+    searchWhileRepublishing<LockPublishedCFS>(s);
+}
+
+/// Decimal strings of the random integers, as identifiers, with a short
+/// common prefix
+std::vector<std::string> makeSortedStrings(int n, int range) {
+    std::vector<std::string> rv;
+    for(auto k: makeRandomVector(n, range)) {
+        rv.push_back("id:" + std::to_string(k));
+    }
+    std::sort(rv.begin(), rv.end());
+    return rv;
+}
+
+struct StringCFS {
+    std::vector<std::string> cfs;
+
+    StringCFS(const std::vector<std::string> &sorted) {
+        zoo::transformToCFS(back_inserter(cfs), sorted.begin(), sorted.end());
+    }
+
+    bool contains(const std::string &k) const {
+        auto e = cfs.cend();
+        auto where = zoo::cfsLowerBound(cfs.cbegin(), e, k);
+        return e != where && k == *where;
+    }
+};
+
+/// Lookups of strings, the index is either a CFS array of \c std::string
+/// or a \c zoo::CfsStringIndex
+template<typename Index>
+void searchStrings(benchmark::State &s) {
+    auto n = s.range(0);
+    Index index(makeSortedStrings(n, 2*n));
+    constexpr auto mask = (1 << 16) - 1;
+    auto keys = makeSortedStrings(mask + 1, 2*n);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937{});
+    auto kNdx = 0;
+    auto found = 0;
+    for(auto _: s) {
+        found += index.contains(keys[kNdx++]);
+        kNdx &= mask;
+    }
+    benchmark::DoNotOptimize(found);
+    s.SetItemsProcessed(s.iterations());
+}
+
+struct PrefixedStringCFS: zoo::CfsStringIndex {
+    PrefixedStringCFS(const std::vector<std::string> &sorted):
+        zoo::CfsStringIndex(sorted.begin(), sorted.end())
+    {}
+};
+
+void searchStringCFS(benchmark::State &s) {
+    searchStrings<StringCFS>(s);
+}
+
+void searchPrefixedStringCFS(benchmark::State &s) {
+    searchStrings<PrefixedStringCFS>(s);
+}
+
+/// Sorted keys with about a hundred repetitions of each
+std::vector<int> makeRepetitiveSorted(int n) {
+    auto rv = makeRandomVector(n, std::max(1, n / 100));
+    std::sort(rv.begin(), rv.end());
+    return rv;
+}
+
+/// Equal ranges of keys with heavy repetitions, the sizes of the ranges
+/// are accumulated so that the searches can not be elided
+void equalRangeRepetitiveCFS(benchmark::State &s) {
+    auto n = s.range(0);
+    auto sorted = makeRepetitiveSorted(n);
+    std::vector<int> cfs;
+    zoo::transformToCFS(back_inserter(cfs), sorted.begin(), sorted.end());
+    constexpr auto mask = (1 << 20) - 1;
+    auto keys = makeRandomVector(mask + 1, n / 50 + 1);
+    auto kNdx = 0;
+    auto b = cfs.cbegin(), e = cfs.cend();
+    long total = 0;
+    for(auto _: s) {
+        auto range = zoo::cfsEqualRange(b, e, keys[kNdx++]);
+        total +=
+            zoo::cfsRank(b, e, range.second) - zoo::cfsRank(b, e, range.first);
+        kNdx &= mask;
+    }
+    benchmark::DoNotOptimize(total);
+    s.SetItemsProcessed(s.iterations());
+}
+
+void equalRangeRepetitiveDeduplicated(benchmark::State &s) {
+    auto n = s.range(0);
+    auto sorted = makeRepetitiveSorted(n);
+    zoo::DeduplicatedCFS<int> index(sorted.begin(), sorted.end());
+    constexpr auto mask = (1 << 20) - 1;
+    auto keys = makeRandomVector(mask + 1, n / 50 + 1);
+    auto kNdx = 0;
+    long total = 0;
+    for(auto _: s) {
+        auto range = index.equalRange(keys[kNdx++]);
+        total += range.second - range.first;
+        kNdx &= mask;
+    }
+    benchmark::DoNotOptimize(total);
+    s.counters["distinct"] = index.distinct();
+    s.SetItemsProcessed(s.iterations());
+}
+
+/// Intersects two CFS arrays as the set operations do
+struct IntersectCFS {
+    template<typename I, typename O>
+    static O intersect(I b1, I e1, I b2, I e2, O out) {
+        return zoo::cfsIntersect(b1, e1, b2, e2, out);
+    }
+};
+
+struct IntersectCFSSimd {
+    template<typename I, typename O>
+    static O intersect(I b1, I e1, I b2, I e2, O out) {
+        return zoo::cfsIntersect(zoo::SimdMerge{}, b1, e1, b2, e2, out);
+    }
+};
+
+/// Converts both arrays back to sorted order first
+struct IntersectThroughSorted {
+    template<typename I, typename O>
+    static O intersect(I b1, I e1, I b2, I e2, O out) {
+        std::vector<int> sorted1(e1 - b1), sorted2(e2 - b2);
+        std::copy(
+            zoo::cfsInorderBegin(b1, e1), zoo::cfsInorderEnd(b1, e1),
+            sorted1.begin()
+        );
+        std::copy(
+            zoo::cfsInorderBegin(b2, e2), zoo::cfsInorderEnd(b2, e2),
+            sorted2.begin()
+        );
+        return std::set_intersection(
+            sorted1.begin(), sorted1.end(), sorted2.begin(), sorted2.end(), out
+        );
+    }
+};
+
+/// Arguments: the size of the first array and how many times smaller the
+/// second is; the keys are unique, half of them in both
+template<typename Intersection>
+void intersection(benchmark::State &s) {
+    auto n = s.range(0), m = std::max<long>(1, n / s.range(1));
+    auto makeCFS = [](int size, int scale) {
+        auto keys = makeRandomVector(size, 2 * size);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        for(auto &k: keys) { k *= scale; }
+        std::vector<int> rv;
+        zoo::transformToCFS(back_inserter(rv), keys.begin(), keys.end());
+        return rv;
+    };
+    auto first = makeCFS(n, 1), second = makeCFS(m, s.range(1));
+    std::vector<int> result;
+    result.reserve(std::min(first.size(), second.size()));
+    for(auto _: s) {
+        result.clear();
+        Intersection::intersect(
+            first.cbegin(), first.cend(), second.cbegin(), second.cend(),
+            back_inserter(result)
+        );
+        benchmark::DoNotOptimize(result.data());
+    }
+    s.counters["matches"] = result.size();
+    s.SetItemsProcessed(s.iterations() * (first.size() + second.size()));
+}
+
+void intersectCFS(benchmark::State &s) {
+    intersection<IntersectCFS>(s);
+}
+
+void intersectCFSSimd(benchmark::State &s) {
+    intersection<IntersectCFSSimd>(s);
+}
+
+void intersectThroughSorted(benchmark::State &s) {
+    intersection<IntersectThroughSorted>(s);
+}
+
+void intersectionArguments(benchmark::internal::Benchmark *b) {
+    for(auto size = RangeLow; size <= RangeHigh; size *= 10) {
+        for(auto ratio: {1, 1000}) {
+            b->Args({size, ratio});
+        }
+    }
+}
+
+/// Sums of the keys in ranges of about a hundredth of the keys, with the
+/// subtree sums of the CFS array
+void rangeSumCFS(benchmark::State &s) {
+    auto n = s.range(0);
+    auto &cfs = spaceFor<UseCFSLowerBound>(n);
+    std::vector<long> values(cfs.begin(), cfs.end()), sums(n);
+    zoo::cfsSubtreeAggregates(
+        values.cbegin(), values.cend(), sums.begin(), std::plus<long>{}
+    );
+    constexpr auto mask = (1 << 20) - 1;
+    auto keys = makeRandomVector(mask + 1, 2*n);
+    auto kNdx = 0;
+    long total = 0;
+    for(auto _: s) {
+        auto lo = keys[kNdx++];
+        total +=
+            zoo::cfsSum(
+                cfs.cbegin(), cfs.cend(), values.cbegin(), sums.cbegin(),
+                lo, int(lo + n / 50)
+            );
+        kNdx &= mask;
+    }
+    benchmark::DoNotOptimize(total);
+    s.SetItemsProcessed(s.iterations());
+}
+
+/// The same sums scanning between the bounds in the sorted array
+void rangeSumSortedScan(benchmark::State &s) {
+    auto n = s.range(0);
+    auto &sorted = spaceFor<UseSTL>(n);
+    constexpr auto mask = (1 << 20) - 1;
+    auto keys = makeRandomVector(mask + 1, 2*n);
+    auto kNdx = 0;
+    long total = 0;
+    for(auto _: s) {
+        auto lo = keys[kNdx++];
+        auto b = std::lower_bound(sorted.cbegin(), sorted.cend(), lo);
+        auto e = std::lower_bound(b, sorted.cend(), int(lo + n / 50));
+        total = std::accumulate(b, e, total);
+        kNdx &= mask;
+    }
+    benchmark::DoNotOptimize(total);
+    s.SetItemsProcessed(s.iterations());
+}
+
 static_assert(64 == sizeof(CacheLine));
 static_assert(64 == alignof(CacheLine));
 
 //BENCHMARK(searchCacheLineCFS)->Arg(RangeHigh);//->Complexity();
 BENCHMARK(searchCacheLineSTL)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);
 BENCHMARK(searchCacheLineCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);
+BENCHMARK(searchCacheLineCfsMap)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);
+
+BENCHMARK(sweepSTL)->Apply(cacheSweepArguments<sizeof(int)>);
+BENCHMARK(sweepCFSLowerBound)->Apply(cacheSweepArguments<sizeof(int)>);
+BENCHMARK(sweepCFSEarly)->Apply(cacheSweepArguments<sizeof(int)>);
+BENCHMARK(sweepCacheLineSTL)->Apply(cacheSweepArguments<sizeof(CacheLine)>);
+BENCHMARK(sweepCacheLineCFS)->Apply(cacheSweepArguments<sizeof(CacheLine)>);
+BENCHMARK(sweepCacheLineCfsMap)->Apply(cacheSweepArguments<sizeof(CacheLine)>);
+
+BENCHMARK(mixedCfsSet)->Apply(mixedArguments);
+BENCHMARK(mixedSTLSet)->Apply(mixedArguments);
+
+BENCHMARK(rangeSumCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);
+BENCHMARK(rangeSumSortedScan)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);
+
+BENCHMARK(searchVEB)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);
+
+BENCHMARK(holdSTLPriorityQueue)->RangeMultiplier(10)->Range(1000, RangeHigh);
+BENCHMARK(holdDaryHeap)->RangeMultiplier(10)->Range(1000, RangeHigh);
+BENCHMARK(holdDaryHeap4)->RangeMultiplier(10)->Range(1000, RangeHigh);
+BENCHMARK(heapifySTLPriorityQueue)->RangeMultiplier(10)->Range(1000, RangeHigh)->Unit(benchmark::kMicrosecond);
+BENCHMARK(heapifyDaryHeap)->RangeMultiplier(10)->Range(1000, RangeHigh)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(searchCompositeRowsCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh / 10);
+BENCHMARK(searchCompositeColumnsCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh / 10);
+
+BENCHMARK(searchSnapshotPublished)->Arg(RangeLow * 10)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(searchLockPublished)->Arg(RangeLow * 10)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK(searchStringCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh / 10);
+BENCHMARK(searchPrefixedStringCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh / 10);
+
+BENCHMARK(equalRangeRepetitiveCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);
+BENCHMARK(equalRangeRepetitiveDeduplicated)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);
+
+BENCHMARK(intersectCFS)->Apply(intersectionArguments)->Unit(benchmark::kMicrosecond);
+BENCHMARK(intersectCFSSimd)->Apply(intersectionArguments)->Unit(benchmark::kMicrosecond);
+BENCHMARK(intersectThroughSorted)->Apply(intersectionArguments)->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(justARandomKey)->Unit(benchmark::kMicrosecond);
 BENCHMARK(justARandomKeyCallingOpaque);
@@ -304,13 +1346,28 @@ BENCHMARK(justTraversingRandomVector)->RangeMultiplier(10)->Range(RangeLow, Rang
 BENCHMARK(searchLinear)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);//->Complexity();
 BENCHMARK(searchSTL)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
 BENCHMARK(searchCFSLowerBound)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchSTLHugePages)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchCFSLowerBoundHugePages)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchCFSBranchFree)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchCFSBranchFreeNoPrefetch)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchLearnedIndex)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchCFSBloom)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchCFSLowerBoundBatch)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchCfsIndex)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchCfsIndexBranchFree)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchKaryCFS)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
 BENCHMARK(searchUnordered)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
+BENCHMARK(searchFlatHashSet)->RangeMultiplier(3)->Range(1, RangeHigh);//->Complexity();
 BENCHMARK(searchCFSLateOld)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);//->Complexity();
 BENCHMARK(searchCFSEarly)->RangeMultiplier(10)->Range(RangeLow, RangeHigh);//->Complexity();
 BENCHMARK(genLinearVector)->RangeMultiplier(10)->Range(RangeLow, RangeHigh)->Unit(benchmark::kMicrosecond);//->Complexity();
 BENCHMARK(randomVector)->RangeMultiplier(10)->Range(RangeLow, RangeHigh)->Unit(benchmark::kMicrosecond);//->Complexity();
 BENCHMARK(sortSTLRandomVector)->RangeMultiplier(10)->Range(RangeLow, RangeHigh)->Unit(benchmark::kMicrosecond);//->Complexity();
+BENCHMARK(sortThenTransformToCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh)->Unit(benchmark::kMicrosecond);//->Complexity();
+BENCHMARK(sortToCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh)->Unit(benchmark::kMicrosecond);//->Complexity();
 BENCHMARK(transformationToCFS)->RangeMultiplier(10)->Range(RangeLow, RangeHigh)->Unit(benchmark::kMicrosecond);//->Complexity();
+BENCHMARK(transformationToCFSInPlace)->RangeMultiplier(10)->Range(RangeLow, RangeHigh)->Unit(benchmark::kMicrosecond);//->Complexity();
+BENCHMARK(transformationToCFSParallel)->Apply(parallelArguments)->UseRealTime()->Unit(benchmark::kMicrosecond);
 
 BENCHMARK_MAIN();
 
@@ -1,6 +1,8 @@
 #ifndef ZOO_BENCHMARK_CFS_UTILITY
 #define ZOO_BENCHMARK_CFS_UTILITY
 
+#include <zoo/AlignedAllocator.h>
+
 #include <vector>
 #include <random>
 
@@ -13,6 +15,9 @@ int randomTwo30();
 
 std::vector<int> makeRandomVector(int size, int range = 0);
 
+template<typename T>
+using CacheAlignedVector = std::vector<T, zoo::AlignedAllocator<T>>;
+
 constexpr auto RangeLow = 10000;
 constexpr auto RangeHigh = RangeLow * 10000;
 
@@ -0,0 +1,150 @@
+#include "./perf_counters.h"
+
+#include <algorithm>
+#include <iterator>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace {
+
+#ifdef __linux__
+std::uint64_t cacheMissConfig(std::uint64_t cache) {
+    return
+        cache |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+int openCounter(std::uint64_t config) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HW_CACHE;
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // this thread, any processor, not in a group
+    return syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+#endif
+
+}
+
+PerfCounters::PerfCounters(Opener open) {
+    for(auto &d: descriptors_) { d = -1; }
+    #ifdef __linux__
+    if(!open) { open = openCounter; }
+    descriptors_[L1DMisses] = open(cacheMissConfig(PERF_COUNT_HW_CACHE_L1D));
+    descriptors_[LLCMisses] = open(cacheMissConfig(PERF_COUNT_HW_CACHE_LL));
+    descriptors_[DTLBMisses] = open(
+        cacheMissConfig(PERF_COUNT_HW_CACHE_DTLB)
+    );
+    #else
+    static_cast<void>(open);
+    #endif
+}
+
+PerfCounters::~PerfCounters() {
+    #ifdef __linux__
+    for(auto d: descriptors_) {
+        if(0 <= d) { close(d); }
+    }
+    #endif
+}
+
+bool PerfCounters::anyValid() const {
+    return std::any_of(
+        std::begin(descriptors_), std::end(descriptors_),
+        [](int d) { return 0 <= d; }
+    );
+}
+
+void PerfCounters::start() {
+    #ifdef __linux__
+    for(auto d: descriptors_) {
+        if(d < 0) { continue; }
+        ioctl(d, PERF_EVENT_IOC_RESET, 0);
+        ioctl(d, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    #endif
+}
+
+void PerfCounters::stop() {
+    #ifdef __linux__
+    for(auto d: descriptors_) {
+        if(0 <= d) { ioctl(d, PERF_EVENT_IOC_DISABLE, 0); }
+    }
+    #endif
+}
+
+std::uint64_t PerfCounters::read(Event e) const {
+    #ifdef __linux__
+    if(!valid(e)) { return 0; }
+    struct { std::uint64_t value, enabled, running; } counts;
+    if(sizeof(counts) != ::read(descriptors_[e], &counts, sizeof(counts))) {
+        return 0;
+    }
+    return scaledCount(counts.value, counts.enabled, counts.running);
+    #else
+    return 0;
+    #endif
+}
+
+const char *PerfCounters::name(Event e) {
+    switch(e) {
+        case L1DMisses: return "L1DMissesPerQuery";
+        case LLCMisses: return "LLCMissesPerQuery";
+        case DTLBMisses: return "dTLBMissesPerQuery";
+        default: return "unknown";
+    }
+}
+
+std::vector<std::size_t> dataCacheSizes() {
+    std::vector<std::size_t> rv;
+    #if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+    for(auto level: {
+        _SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL2_CACHE_SIZE, _SC_LEVEL3_CACHE_SIZE,
+        _SC_LEVEL4_CACHE_SIZE
+    }) {
+        auto size = sysconf(level);
+        if(0 < size) { rv.push_back(size); }
+    }
+    #endif
+    return rv;
+}
+
+std::vector<long> cacheSweepSizes(
+    std::size_t elementSize, std::size_t maximumBytes
+) {
+    auto caches = dataCacheSizes();
+    if(caches.empty()) { caches = {32 << 10, 1 << 20, 32 << 20}; }
+    std::vector<std::size_t> bytes;
+    for(auto size: caches) {
+        for(auto fraction: {size / 4, size / 2, size, size * 2}) {
+            bytes.push_back(fraction);
+        }
+    }
+    for(auto beyond = caches.back() * 8; ; beyond *= 4) {
+        bytes.push_back(std::min(beyond, maximumBytes));
+        if(maximumBytes <= beyond) { break; }
+    }
+    std::vector<long> rv;
+    for(auto b: bytes) {
+        if(maximumBytes < b) { continue; }
+        auto elements = long(b / elementSize);
+        if(0 < elements) { rv.push_back(elements); }
+    }
+    std::sort(rv.begin(), rv.end());
+    rv.erase(std::unique(rv.begin(), rv.end()), rv.end());
+    return rv;
+}
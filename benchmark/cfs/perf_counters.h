@@ -0,0 +1,66 @@
+#ifndef ZOO_BENCHMARK_PERF_COUNTERS
+#define ZOO_BENCHMARK_PERF_COUNTERS
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Hardware counters of the misses of the calling thread, through
+/// perf_event_open; on systems without it, or when perf_event_paranoid or
+/// the lack of a PMU (as in many virtual machines) do not allow the events,
+/// the counters are not valid and read 0
+class PerfCounters {
+public:
+    enum Event { L1DMisses, LLCMisses, DTLBMisses, EventCount };
+
+    /// Opens the counter of a cache miss event, given as the \c config of
+    /// perf_event_attr; a negative result means the event is not available
+    using Opener = int (*)(std::uint64_t config);
+
+    /// \param open the opening of each counter, by default perf_event_open
+    explicit PerfCounters(Opener open = nullptr);
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool valid(Event e) const { return 0 <= descriptors_[e]; }
+    bool anyValid() const;
+
+    /// Resets and enables the valid counters
+    void start();
+    void stop();
+
+    /// The count since \c start, scaled if the kernel multiplexed the event
+    std::uint64_t read(Event e) const;
+
+    static const char *name(Event e);
+
+private:
+    int descriptors_[EventCount];
+};
+
+/// The count the kernel reports for an event that was \c running of the
+/// \c enabled time, extrapolated to all of it when the event shared the PMU
+/// with others; 0 if it never ran
+inline std::uint64_t scaledCount(
+    std::uint64_t value, std::uint64_t enabled, std::uint64_t running
+) {
+    if(0 == running) { return 0; }
+    if(running < enabled) { return value * double(enabled) / running; }
+    return value;
+}
+
+/// The sizes in bytes of the data caches, from the lowest level, as
+/// reported by the system; empty if unknown
+std::vector<std::size_t> dataCacheSizes();
+
+/// Counts of elements of \c elementSize bytes around each of the cache
+/// boundaries, a quarter, half, once and twice each size, then beyond the
+/// last level up to \c maximumBytes; common sizes are assumed if the system
+/// does not report them
+std::vector<long> cacheSweepSizes(
+    std::size_t elementSize, std::size_t maximumBytes
+);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef ZOO_ALIGNED_ALLOCATOR
+#define ZOO_ALIGNED_ALLOCATOR
+
+#ifndef SIMPLIFY_INCLUDES
+#include <cstddef>
+#include <new>
+#endif
+
+namespace zoo {
+
+/// \brief Allocator of storage aligned to \c Alignment, the default is the
+/// cache line, for layouts that rely on their nodes being cache lines
+template<typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(
+            ::operator new(n * sizeof(T), std::align_val_t{Alignment})
+        );
+    }
+
+    void deallocate(T *p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept {
+        return true;
+    }
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment> &) const noexcept {
+        return false;
+    }
+};
+
+}
+
+#endif
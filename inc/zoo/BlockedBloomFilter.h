@@ -0,0 +1,104 @@
+#ifndef ZOO_BLOCKED_BLOOM_FILTER
+#define ZOO_BLOCKED_BLOOM_FILTER
+
+#include <zoo/AlignedAllocator.h>
+#include <zoo/util/hash_mix.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <cstdint>
+#include <functional>
+#include <vector>
+#endif
+
+namespace zoo {
+
+/// \brief Approximate membership filter in which all the bits of a key are
+/// in the same cache line
+///
+/// A key selects one block of eight 64-bit words and sets one bit in each
+/// word, the queries of keys not inserted cost a single memory access,
+/// and fail with the probability of the false positives: about 1% at the
+/// default of 10 bits per distinct key, 3% at 8 and 0.4% at 12.  The bits
+/// are reserved per inserted element, repeated keys leave more bits for
+/// the distinct ones and lower the rate: with a third of the elements
+/// repeated, about 16 bits per distinct key, the rate is near 0.1%.
+/// Meant to be built with a static search structure, as a CFS array, to
+/// spare its searches of missing keys.
+template<typename T, typename Hash = std::hash<T>>
+class BlockedBloomFilter {
+    constexpr static auto WordsPerBlock = 8;
+
+    struct alignas(64) Block {
+        std::uint64_t words[WordsPerBlock];
+    };
+
+    std::vector<Block, AlignedAllocator<Block>> blocks_;
+    Hash hash_;
+
+    /// \brief The index of the block of \c k, and in \c bits the bit of
+    /// each word: the high half of the hash selects the block, the low half
+    /// the bits
+    std::size_t probe(
+        const T &k, std::uint64_t (&bits)[WordsPerBlock]
+    ) const noexcept {
+        constexpr static std::uint32_t Salts[WordsPerBlock] = {
+            0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+            0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+        };
+        auto h = mixHash(hash_(k));
+        auto low = std::uint32_t(h);
+        for(auto ndx = 0; ndx < WordsPerBlock; ++ndx) {
+            bits[ndx] = std::uint64_t(1) << ((low * Salts[ndx]) >> 26);
+        }
+        return ((h >> 32) * std::uint64_t(blocks_.size())) >> 32;
+    }
+
+public:
+    /// \param expectedCount of keys, for which \c bitsPerKey are reserved
+    explicit BlockedBloomFilter(
+        std::size_t expectedCount = 0, std::size_t bitsPerKey = 10,
+        Hash h = Hash{}
+    ):
+        blocks_(
+            (expectedCount * bitsPerKey + sizeof(Block) * 8 - 1) /
+                (sizeof(Block) * 8) + 1,
+            Block{}
+        ),
+        hash_{h}
+    {}
+
+    /// \brief Filter of the keys in [begin, end)
+    template<typename I>
+    BlockedBloomFilter(I begin, I end, std::size_t bitsPerKey = 10):
+        BlockedBloomFilter(end - begin, bitsPerKey)
+    {
+        for(; begin != end; ++begin) { insert(*begin); }
+    }
+
+    void insert(const T &k) {
+        std::uint64_t bits[WordsPerBlock];
+        auto &block = blocks_[probe(k, bits)];
+        for(auto ndx = 0; ndx < WordsPerBlock; ++ndx) {
+            block.words[ndx] |= bits[ndx];
+        }
+    }
+
+    /// \brief false only if \c k was not inserted
+    bool mayContain(const T &k) const noexcept {
+        std::uint64_t bits[WordsPerBlock];
+        auto &block = blocks_[probe(k, bits)];
+        std::uint64_t missing = 0;
+        for(auto ndx = 0; ndx < WordsPerBlock; ++ndx) {
+            missing |= ~block.words[ndx] & bits[ndx];
+        }
+        return !missing;
+    }
+
+    std::size_t bytes() const noexcept {
+        return blocks_.size() * sizeof(Block);
+    }
+};
+
+}
+
+#endif
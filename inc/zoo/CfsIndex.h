@@ -0,0 +1,88 @@
+#ifndef ZOO_CFS_INDEX
+#define ZOO_CFS_INDEX
+
+#include <zoo/algorithm/cfs.h>
+#include <zoo/AlignedAllocator.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <vector>
+#endif
+
+namespace zoo {
+
+/// \brief Owning CFS layout in cache line aligned storage, shifted by one
+/// element
+///
+/// The element of one-based index k is in slot k of the storage, slot 0 is
+/// padding: the children of k are the slots 2k and 2k + 1, which start at
+/// an even slot, hence both are in the same cache line when the size of
+/// the elements divides it, and the descendants of k some levels below
+/// start at a cache line boundary, which is what the prefetching of
+/// \c BranchFree loads.  The searches are those of the functions of the
+/// same names.
+template<
+    typename T, typename Compare = Less,
+    typename Allocator = AlignedAllocator<T>
+>
+class CfsIndex {
+    std::vector<T, Allocator> storage_;
+    Compare compare_;
+
+public:
+    CfsIndex() = default;
+
+    /// \brief From the sorted range [begin, end)
+    template<typename I>
+    CfsIndex(
+        I begin, I end,
+        Compare c = Compare{}, const Allocator &a = Allocator{}
+    ):
+        storage_(a), compare_{c}
+    {
+        if(begin == end) { return; }
+        storage_.reserve((end - begin) + 1);
+        // the padding is a copy to not require default construction
+        storage_.push_back(*begin);
+        transformToCFS(back_inserter(storage_), begin, end);
+    }
+
+    std::size_t size() const noexcept {
+        return storage_.empty() ? 0 : storage_.size() - 1;
+    }
+
+    /// \brief The elements, in CFS order
+    const T *begin() const noexcept {
+        auto d = storage_.data();
+        return storage_.empty() ? d : d + 1;
+    }
+    const T *end() const noexcept { return begin() + size(); }
+
+    template<typename E>
+    const T *lowerBound(const E &v) const {
+        return cfsLowerBound(begin(), end(), v, compare_);
+    }
+
+    template<typename Policy, typename E>
+    const T *lowerBound(Policy p, const E &v) const {
+        return cfsLowerBound(p, begin(), end(), v, compare_);
+    }
+
+    template<typename E>
+    const T *higherBound(const E &v) const {
+        return cfsHigherBound(begin(), end(), v, compare_);
+    }
+
+    template<typename Policy, typename E>
+    const T *higherBound(Policy p, const E &v) const {
+        return cfsHigherBound(p, begin(), end(), v, compare_);
+    }
+
+    template<typename E>
+    auto equalRange(const E &v) const {
+        return cfsEqualRange(begin(), end(), v, compare_);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef ZOO_CFS_MAP
+#define ZOO_CFS_MAP
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <algorithm>
+#include <utility>
+#include <vector>
+#endif
+
+namespace zoo {
+
+/// \brief Map searched in a CFS layout of the keys alone, the values are in
+/// a parallel array in the same order
+///
+/// The search touches only the keys, the value is loaded only for the
+/// element found.  Since the CFS transformation depends only on the count
+/// of elements, transforming the values applies the same permutation.
+template<typename K, typename V, typename Compare = Less>
+class CfsMap {
+    std::vector<K> keys_;
+    std::vector<V> values_;
+    Compare compare_;
+
+public:
+    CfsMap() = default;
+
+    /// \brief From the sorted keys [keysBegin, keysEnd) and the values
+    /// starting at \c valuesBegin in the same order
+    template<typename KI, typename VI>
+    CfsMap(KI keysBegin, KI keysEnd, VI valuesBegin, Compare c = Compare{}):
+        compare_{c}
+    {
+        auto size = keysEnd - keysBegin;
+        keys_.reserve(size);
+        values_.reserve(size);
+        transformToCFS(back_inserter(keys_), keysBegin, keysEnd);
+        transformToCFS(
+            back_inserter(values_), valuesBegin, valuesBegin + size
+        );
+    }
+
+    /// \brief From key-value pairs in any order, equivalent keys keep their
+    /// relative order
+    explicit CfsMap(
+        std::vector<std::pair<K, V>> pairs, Compare c = Compare{}
+    ):
+        compare_{c}
+    {
+        std::stable_sort(
+            pairs.begin(), pairs.end(),
+            [c](const auto &l, const auto &r) mutable {
+                return c(l.first, r.first);
+            }
+        );
+        std::vector<K> keys;
+        std::vector<V> values;
+        keys.reserve(pairs.size());
+        values.reserve(pairs.size());
+        for(auto &p: pairs) {
+            keys.push_back(std::move(p.first));
+            values.push_back(std::move(p.second));
+        }
+        *this = CfsMap(keys.begin(), keys.end(), values.begin(), c);
+    }
+
+    std::size_t size() const noexcept { return keys_.size(); }
+
+    /// \brief The keys, in CFS order
+    auto begin() const noexcept { return keys_.data(); }
+    auto end() const noexcept { return keys_.data() + keys_.size(); }
+
+    const K &key(std::size_t ndx) const { return keys_[ndx]; }
+    const V &value(std::size_t ndx) const { return values_[ndx]; }
+    V &value(std::size_t ndx) { return values_[ndx]; }
+
+    /// \brief The index of the first key not less than \c k, size() if none
+    template<typename E>
+    std::size_t lowerBound(const E &k) const {
+        return cfsLowerBound(begin(), end(), k, compare_) - begin();
+    }
+
+    /// \brief The value of the first key equivalent to \c k, nullptr if
+    /// none
+    template<typename E>
+    const V *find(const E &k) const {
+        auto ndx = lowerBound(k);
+        if(size() == ndx) { return nullptr; }
+        auto c = compare_;
+        if(c(k, keys_[ndx])) { return nullptr; }
+        return &values_[ndx];
+    }
+
+    template<typename E>
+    V *find(const E &k) {
+        return const_cast<V *>(static_cast<const CfsMap &>(*this).find(k));
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef ZOO_CFS_SET
+#define ZOO_CFS_SET
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <algorithm>
+#include <vector>
+#endif
+
+namespace zoo {
+
+/// \brief Set of unique keys searched in a static CFS layout, with updates
+/// buffered until their count passes a threshold
+///
+/// The keys inserted that are not in the CFS layout are kept sorted apart,
+/// the keys erased from the layout are kept sorted as tombstones; lookups
+/// query both.  When the count of buffered updates passes the threshold,
+/// the layout is rebuilt merging them in.
+template<typename T, typename Compare = Less>
+class CfsSet {
+    std::vector<T> cfs_, inserted_, erased_;
+    std::size_t rebuildThreshold_;
+    Compare compare_;
+
+    bool equivalent(const T &l, const T &r) const {
+        auto c = compare_;
+        return not c(l, r) && not c(r, l);
+    }
+
+    auto findSorted(const std::vector<T> &v, const T &k) const {
+        auto where = std::lower_bound(v.begin(), v.end(), k, compare_);
+        return v.end() != where && equivalent(*where, k) ? where : v.end();
+    }
+
+    bool inCFS(const T &k) const {
+        auto e = cfs_.end();
+        auto where = cfsLowerBound(cfs_.begin(), e, k, compare_);
+        return e != where && equivalent(*where, k);
+    }
+
+    void maybeRebuild() {
+        if(rebuildThreshold_ < pending()) { rebuild(); }
+    }
+
+    template<typename I>
+    void build(I begin, I end) {
+        cfs_.clear();
+        cfs_.reserve(end - begin);
+        transformToCFS(back_inserter(cfs_), begin, end);
+    }
+
+public:
+    explicit CfsSet(
+        std::size_t rebuildThreshold = 1024, Compare c = Compare{}
+    ):
+        rebuildThreshold_{rebuildThreshold}, compare_{c}
+    {}
+
+    /// \brief The set of the keys in [begin, end), in any order
+    template<typename I>
+    CfsSet(
+        I begin, I end,
+        std::size_t rebuildThreshold = 1024, Compare c = Compare{}
+    ):
+        CfsSet{rebuildThreshold, c}
+    {
+        std::vector<T> sorted(begin, end);
+        std::sort(sorted.begin(), sorted.end(), compare_);
+        auto unique =
+            std::unique(
+                sorted.begin(), sorted.end(),
+                [this](const T &l, const T &r) { return equivalent(l, r); }
+            );
+        build(sorted.begin(), unique);
+    }
+
+    std::size_t size() const noexcept {
+        return cfs_.size() - erased_.size() + inserted_.size();
+    }
+
+    /// \brief The count of buffered insertions and erasures
+    std::size_t pending() const noexcept {
+        return inserted_.size() + erased_.size();
+    }
+
+    bool contains(const T &k) const {
+        if(inserted_.end() != findSorted(inserted_, k)) { return true; }
+        return inCFS(k) && erased_.end() == findSorted(erased_, k);
+    }
+
+    /// \returns whether the key was not already in the set
+    bool insert(const T &k) {
+        if(inserted_.end() != findSorted(inserted_, k)) { return false; }
+        if(inCFS(k)) {
+            auto tombstone = findSorted(erased_, k);
+            if(erased_.end() == tombstone) { return false; }
+            erased_.erase(tombstone);
+            return true;
+        }
+        inserted_.insert(
+            std::upper_bound(inserted_.begin(), inserted_.end(), k, compare_),
+            k
+        );
+        maybeRebuild();
+        return true;
+    }
+
+    /// \returns whether the key was in the set
+    bool erase(const T &k) {
+        auto buffered = findSorted(inserted_, k);
+        if(inserted_.end() != buffered) {
+            inserted_.erase(buffered);
+            return true;
+        }
+        if(not inCFS(k)) { return false; }
+        auto where =
+            std::lower_bound(erased_.begin(), erased_.end(), k, compare_);
+        if(erased_.end() != where && equivalent(*where, k)) { return false; }
+        erased_.insert(where, k);
+        maybeRebuild();
+        return true;
+    }
+
+    /// \brief The least element not less than \c k, nullptr if there is
+    /// none
+    const T *lowerBound(const T &k) const {
+        const T *rv = nullptr;
+        auto b = cfs_.begin(), e = cfs_.end();
+        // skips the tombstones in order
+        auto inorderEnd = cfsInorderEnd(b, e);
+        for(
+            auto i = cfsInorder(b, e, cfsLowerBound(b, e, k, compare_));
+            inorderEnd != i;
+            ++i
+        ) {
+            if(erased_.end() == findSorted(erased_, *i)) {
+                rv = &*i;
+                break;
+            }
+        }
+        auto buffered =
+            std::lower_bound(inserted_.begin(), inserted_.end(), k, compare_);
+        if(inserted_.end() != buffered) {
+            auto c = compare_;
+            if(!rv || c(*buffered, *rv)) { rv = &*buffered; }
+        }
+        return rv;
+    }
+
+    /// \brief Merges the buffered updates into the CFS layout
+    void rebuild() {
+        std::vector<T> sorted;
+        sorted.reserve(size());
+        auto tombstone = erased_.begin();
+        auto buffered = inserted_.begin();
+        auto c = compare_;
+        auto b = cfs_.cbegin(), e = cfs_.cend();
+        for(
+            auto i = cfsInorderBegin(b, e), inorderEnd = cfsInorderEnd(b, e);
+            inorderEnd != i;
+            ++i
+        ) {
+            auto &element = *i;
+            while(inserted_.end() != buffered && c(*buffered, element)) {
+                sorted.push_back(*buffered++);
+            }
+            if(erased_.end() != tombstone && equivalent(*tombstone, element)) {
+                ++tombstone;
+                continue;
+            }
+            sorted.push_back(element);
+        }
+        sorted.insert(sorted.end(), buffered, inserted_.end());
+        build(sorted.begin(), sorted.end());
+        inserted_.clear();
+        erased_.clear();
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef ZOO_CFS_SNAPSHOT_HANDLE
+#define ZOO_CFS_SNAPSHOT_HANDLE
+
+#ifndef SIMPLIFY_INCLUDES
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#endif
+
+namespace zoo {
+
+/// \brief Publishes immutable versions of an index to concurrent readers,
+/// reclaiming the versions replaced once no reader may be using them
+///
+/// Readers are wait-free: acquiring a snapshot announces the global epoch
+/// in the reader's slot and loads the current version, releasing it clears
+/// the slot; there are no read-modify-write operations nor retries.
+/// Publishing replaces the version, advances the epoch and retires the
+/// version replaced with the new epoch; a retired version is deleted when
+/// every slot is either idle or announces an epoch at least as recent,
+/// since those readers loaded the version after the replacement.
+///
+/// Each reader uses its own slot, by index, the slots are in separate
+/// cache lines so that the announcements do not contend.
+/// \note Publishing is serialized with a mutex, the readers never lock it
+template<typename Index>
+class CfsSnapshotHandle {
+    constexpr static std::uint64_t Idle = 0;
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch{Idle};
+    };
+
+    struct Retired {
+        const Index *version;
+        std::uint64_t epoch;
+    };
+
+    std::atomic<const Index *> current_;
+    std::atomic<std::uint64_t> epoch_{1};
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t readers_;
+    std::mutex publishing_;
+    std::vector<Retired> retired_;
+
+    void reclaimWhilePublishing() {
+        auto oldest = epoch_.load();
+        for(std::size_t ndx = 0; ndx < readers_; ++ndx) {
+            auto announced = slots_[ndx].epoch.load();
+            if(Idle != announced && announced < oldest) { oldest = announced; }
+        }
+        auto kept = retired_.begin();
+        for(auto &r: retired_) {
+            if(r.epoch <= oldest) { delete r.version; }
+            else { *kept++ = r; }
+        }
+        retired_.erase(kept, retired_.end());
+    }
+
+public:
+    /// \brief The version acquired by a reader, valid while this object
+    /// lives; it releases the reader's slot on destruction
+    class Snapshot {
+        const Index *version_;
+        std::atomic<std::uint64_t> *slot_;
+
+        friend class CfsSnapshotHandle;
+
+        Snapshot(const Index *v, std::atomic<std::uint64_t> *s) noexcept:
+            version_{v}, slot_{s}
+        {}
+
+    public:
+        Snapshot(Snapshot &&model) noexcept:
+            version_{model.version_}, slot_{model.slot_}
+        {
+            model.slot_ = nullptr;
+        }
+
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+
+        ~Snapshot() {
+            if(slot_) { slot_->store(Idle, std::memory_order_release); }
+        }
+
+        /// \brief null if nothing has been published
+        const Index *get() const noexcept { return version_; }
+        const Index &operator*() const noexcept { return *version_; }
+        const Index *operator->() const noexcept { return version_; }
+        explicit operator bool() const noexcept { return version_; }
+    };
+
+    /// \param readers the count of reader slots
+    /// \param initial the first version, may be null
+    explicit CfsSnapshotHandle(
+        std::size_t readers, std::unique_ptr<Index> initial = nullptr
+    ):
+        current_{initial.release()},
+        slots_{new Slot[readers]},
+        readers_{readers}
+    {}
+
+    CfsSnapshotHandle(const CfsSnapshotHandle &) = delete;
+    CfsSnapshotHandle &operator=(const CfsSnapshotHandle &) = delete;
+
+    /// \pre no snapshot is alive
+    ~CfsSnapshotHandle() {
+        for(auto &r: retired_) { delete r.version; }
+        delete current_.load();
+    }
+
+    std::size_t readers() const noexcept { return readers_; }
+
+    /// \brief The current version for the reader with the given slot
+    /// \pre \c reader is less than \c readers() and no other snapshot of
+    /// the same reader is alive
+    Snapshot acquire(std::size_t reader) const noexcept {
+        auto &slot = slots_[reader].epoch;
+        // sequentially consistent so that the announcement is visible to
+        // publishers before the version is loaded
+        slot.store(epoch_.load());
+        return {current_.load(), &slot};
+    }
+
+    /// \brief Makes \c next the current version, deleting the versions
+    /// retired that are no longer in use
+    void publish(std::unique_ptr<Index> next) {
+        std::lock_guard<std::mutex> guard(publishing_);
+        auto replaced = current_.exchange(next.release());
+        auto epoch = epoch_.fetch_add(1) + 1;
+        if(replaced) { retired_.push_back({replaced, epoch}); }
+        reclaimWhilePublishing();
+    }
+
+    /// \brief Deletes the versions retired that are no longer in use,
+    /// returns the count of those still pending
+    std::size_t reclaim() {
+        std::lock_guard<std::mutex> guard(publishing_);
+        reclaimWhilePublishing();
+        return retired_.size();
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef ZOO_CFS_STRING_INDEX
+#define ZOO_CFS_STRING_INDEX
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <vector>
+#endif
+
+namespace zoo {
+
+/// \brief A string as a search key: the first 8 characters as a big-endian
+/// integer, inline, with the length and the pointer to all the characters
+///
+/// Comparing the prefixes as integers orders as comparing the characters
+/// as unsigned, the order of \c std::string; the characters are visited
+/// only when the prefixes are equal
+struct PrefixedString {
+    std::uint64_t prefix;
+    std::size_t length;
+    const char *data;
+
+    PrefixedString() = default;
+
+    /// \brief Refers to the characters of \c s, which must outlive it
+    explicit PrefixedString(std::string_view s) noexcept:
+        prefix{0}, length{s.size()}, data{s.data()}
+    {
+        unsigned char bytes[8] = {};
+        if(!s.empty()) {
+            std::memcpy(bytes, s.data(), s.size() < 8 ? s.size() : 8);
+        }
+        for(auto byte: bytes) { prefix = (prefix << 8) | byte; }
+    }
+
+    std::string_view view() const noexcept { return {data, length}; }
+};
+
+/// \brief Orders the prefixed strings and the \c std::string_view probes
+///
+/// Probes as \c PrefixedString are faster since their prefix is computed
+/// once and not at every comparison
+struct PrefixedStringLess {
+    bool operator()(
+        const PrefixedString &l, const PrefixedString &r
+    ) const noexcept {
+        if(l.prefix != r.prefix) { return l.prefix < r.prefix; }
+        // the prefix of shorter strings is padded with zeros
+        if(l.length <= 8 && r.length <= 8) { return l.length < r.length; }
+        return l.view() < r.view();
+    }
+
+    bool operator()(
+        const PrefixedString &l, std::string_view r
+    ) const noexcept {
+        return (*this)(l, PrefixedString(r));
+    }
+
+    bool operator()(
+        std::string_view l, const PrefixedString &r
+    ) const noexcept {
+        return (*this)(PrefixedString(l), r);
+    }
+};
+
+/// \brief CFS layout of prefixed strings, whose characters are held
+/// contiguously by the index
+///
+/// The layout is searched with \c cfsLowerBound and \c PrefixedStringLess;
+/// the descent loads only the keys, one cache miss per level, and not the
+/// characters of the strings unless their prefixes tie
+class CfsStringIndex {
+    std::vector<char> characters_;
+    std::vector<PrefixedString> keys_;
+
+public:
+    CfsStringIndex() = default;
+
+    /// \brief From the sorted range [begin, end) of anything convertible to
+    /// \c std::string_view
+    template<typename I>
+    CfsStringIndex(I begin, I end) {
+        std::size_t total = 0;
+        for(auto i = begin; i != end; ++i) {
+            total += std::string_view(*i).size();
+        }
+        // reserved so that the keys may point to the characters as added
+        characters_.reserve(total);
+        std::vector<PrefixedString> sorted;
+        for(auto i = begin; i != end; ++i) {
+            std::string_view s(*i);
+            auto offset = characters_.size();
+            characters_.insert(characters_.end(), s.begin(), s.end());
+            sorted.emplace_back(
+                std::string_view(characters_.data() + offset, s.size())
+            );
+        }
+        keys_.reserve(sorted.size());
+        transformToCFS(back_inserter(keys_), sorted.begin(), sorted.end());
+    }
+
+    /// \brief The keys of the copy refer to the characters of the copy
+    CfsStringIndex(const CfsStringIndex &model):
+        characters_(model.characters_), keys_(model.keys_)
+    {
+        for(auto &k: keys_) {
+            k.data = characters_.data() + (k.data - model.characters_.data());
+        }
+    }
+
+    CfsStringIndex(CfsStringIndex &&) = default;
+
+    CfsStringIndex &operator=(CfsStringIndex model) noexcept {
+        characters_.swap(model.characters_);
+        keys_.swap(model.keys_);
+        return *this;
+    }
+
+    std::size_t size() const noexcept { return keys_.size(); }
+
+    /// \brief The keys, in CFS order
+    const PrefixedString *begin() const noexcept { return keys_.data(); }
+    const PrefixedString *end() const noexcept {
+        return keys_.data() + keys_.size();
+    }
+
+    const PrefixedString *lowerBound(std::string_view probe) const {
+        return
+            cfsLowerBound(
+                begin(), end(), PrefixedString(probe), PrefixedStringLess{}
+            );
+    }
+
+    bool contains(std::string_view probe) const {
+        auto where = lowerBound(probe);
+        return end() != where && probe == where->view();
+    }
+};
+
+}
+
+#endif
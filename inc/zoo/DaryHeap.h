@@ -0,0 +1,285 @@
+#ifndef ZOO_DARY_HEAP
+#define ZOO_DARY_HEAP
+
+#include <zoo/AlignedAllocator.h>
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace zoo {
+
+/// \brief The default count of children: as many as fill a cache line
+///
+/// Only when the size of \c T divides the 64 bytes of a line do the groups
+/// of children fill whole aligned lines; otherwise they straddle lines
+/// regardless of \c D, then the default is 4, a good arity in general
+template<typename T>
+constexpr int DaryHeapArity =
+    sizeof(T) <= 32 && 0 == 64 % sizeof(T) ? int(64 / sizeof(T)) : 4;
+
+/// \brief The default of \c DaryHeap for the notification of the moves
+/// of elements: no tracking
+struct IgnoreHeapIndex {
+    template<typename T>
+    constexpr void operator()(const T &, std::size_t) const noexcept {}
+};
+
+namespace detail {
+
+#if defined(__SSE2__)
+/// \brief Index of the first minimum of the \c D integers at \c keys
+template<int D>
+int daryMinimumIndex(const int *keys) {
+    static_assert(0 == D % 4);
+    #if defined(__AVX2__)
+    if constexpr(0 == D % 8) {
+        auto load = [&](int ndx) {
+            return
+                _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i *>(keys + ndx)
+                );
+        };
+        auto minimums = load(0);
+        for(auto ndx = 8; ndx < D; ndx += 8) {
+            minimums = _mm256_min_epi32(minimums, load(ndx));
+        }
+        auto halves =
+            _mm_min_epi32(
+                _mm256_castsi256_si128(minimums),
+                _mm256_extracti128_si256(minimums, 1)
+            );
+        halves =
+            _mm_min_epi32(
+                halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(1, 0, 3, 2))
+            );
+        halves =
+            _mm_min_epi32(
+                halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1))
+            );
+        auto broadcast = _mm256_broadcastd_epi32(halves);
+        for(auto ndx = 0; ; ndx += 8) {
+            auto equal = _mm256_cmpeq_epi32(broadcast, load(ndx));
+            auto mask = _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+            if(mask) { return ndx + __builtin_ctz(mask); }
+        }
+    }
+    #endif
+    auto load = [&](int ndx) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + ndx));
+    };
+    // SSE2 does not have the minimum of 32 bit integers, it is blended
+    auto minimum = [](__m128i l, __m128i r) {
+        auto less = _mm_cmplt_epi32(l, r);
+        return _mm_or_si128(_mm_and_si128(less, l), _mm_andnot_si128(less, r));
+    };
+    auto minimums = load(0);
+    for(auto ndx = 4; ndx < D; ndx += 4) {
+        minimums = minimum(minimums, load(ndx));
+    }
+    minimums =
+        minimum(
+            minimums, _mm_shuffle_epi32(minimums, _MM_SHUFFLE(1, 0, 3, 2))
+        );
+    minimums =
+        minimum(
+            minimums, _mm_shuffle_epi32(minimums, _MM_SHUFFLE(2, 3, 0, 1))
+        );
+    for(auto ndx = 0; ; ndx += 4) {
+        auto equal = _mm_cmpeq_epi32(minimums, load(ndx));
+        auto mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+        if(mask) { return ndx + __builtin_ctz(mask); }
+    }
+}
+#endif
+
+}
+
+/// \brief Priority queue as an implicit heap in which every node has \c D
+/// children, the first element is one for which no other compares less
+///
+/// The children of the node k are the nodes D*k + 1 to D*k + D; the
+/// storage starts D - 1 elements before the root so that the children of
+/// every node begin at a multiple of D; then, if D elements fill a cache
+/// line (as with the default arity when the size of T divides 64), each
+/// group of children is one aligned cache line, the height is log_D(n),
+/// and sifting down loads one line per level.  For \c int and the default
+/// comparator, the first of the children is found with SIMD.
+///
+/// \tparam IndexUpdate callable as (const T &element, std::size_t index)
+/// each time an element is placed at an index, in heap order, by an
+/// insertion or a removal, so that the users can keep the positions the
+/// arguments of \c decreaseKey need; the element \c pop removes is not
+/// reported
+/// \pre T is default constructible
+template<
+    typename T,
+    int D = DaryHeapArity<T>,
+    typename Compare = Less,
+    typename IndexUpdate = IgnoreHeapIndex
+>
+class DaryHeap {
+    static_assert(2 <= D, "a heap node has at least two children");
+
+    constexpr static std::size_t Offset = D - 1;
+    constexpr static bool Simd =
+        #if defined(__SSE2__)
+        std::is_same_v<int, T> && std::is_same_v<Less, Compare> &&
+            0 == D % 4;
+        #else
+        false;
+        #endif
+
+    std::vector<T, AlignedAllocator<T>> storage_;
+    Compare compare_;
+    IndexUpdate update_;
+
+    T *data() noexcept { return storage_.data() + Offset; }
+
+    void place(std::size_t ndx, T &&value) {
+        auto &destination = data()[ndx];
+        destination = std::move(value);
+        update_(std::as_const(destination), ndx);
+    }
+
+    std::size_t firstChild(const T *children, std::size_t count) const {
+        #if defined(__SSE2__)
+        if constexpr(Simd) {
+            if(D == count) { return detail::daryMinimumIndex<D>(children); }
+        }
+        #endif
+        std::size_t rv = 0;
+        for(std::size_t ndx = 1; ndx < count; ++ndx) {
+            if(compare_(children[ndx], children[rv])) { rv = ndx; }
+        }
+        return rv;
+    }
+
+    std::size_t siftUp(std::size_t ndx, T value) {
+        auto d = data();
+        while(ndx) {
+            auto parent = (ndx - 1) / D;
+            if(!compare_(value, d[parent])) { break; }
+            place(ndx, std::move(d[parent]));
+            ndx = parent;
+        }
+        place(ndx, std::move(value));
+        return ndx;
+    }
+
+    void siftDown(std::size_t ndx, T value) {
+        auto d = data();
+        auto count = size();
+        for(;;) {
+            auto first = D * ndx + 1;
+            if(count <= first) { break; }
+            auto children = std::min<std::size_t>(D, count - first);
+            auto child = first + firstChild(d + first, children);
+            if(!compare_(d[child], value)) { break; }
+            place(ndx, std::move(d[child]));
+            ndx = child;
+        }
+        place(ndx, std::move(value));
+    }
+
+public:
+    explicit DaryHeap(
+        Compare c = Compare{}, IndexUpdate u = IndexUpdate{}
+    ):
+        storage_(Offset), compare_{c}, update_{u}
+    {}
+
+    template<typename I>
+    DaryHeap(
+        I begin, I end, Compare c = Compare{}, IndexUpdate u = IndexUpdate{}
+    ):
+        DaryHeap(c, u)
+    {
+        heapify(begin, end);
+    }
+
+    std::size_t size() const noexcept { return storage_.size() - Offset; }
+    bool empty() const noexcept { return 0 == size(); }
+
+    /// \brief The elements in heap order
+    const T *begin() const noexcept { return storage_.data() + Offset; }
+    const T *end() const noexcept {
+        return storage_.data() + storage_.size();
+    }
+
+    /// \pre not empty
+    const T &top() const noexcept { return *begin(); }
+
+    void push(T value) {
+        storage_.push_back(std::move(value));
+        auto last = size() - 1;
+        siftUp(last, std::move(data()[last]));
+    }
+
+    /// \pre not empty
+    void pop() {
+        auto last = std::move(storage_.back());
+        storage_.pop_back();
+        if(!empty()) { siftDown(0, std::move(last)); }
+    }
+
+    /// \brief Replaces the element at \c ndx, in heap order, with \c value
+    /// that does not compare after it, and returns where it moved to
+    ///
+    /// The positions of the elements change with every modification, the
+    /// \c IndexUpdate reports them
+    /// \pre ndx < size() and not compare(*(begin() + ndx), value)
+    std::size_t decreaseKey(std::size_t ndx, T value) {
+        return siftUp(ndx, std::move(value));
+    }
+
+    /// \brief Inserts the range [b, e) at once
+    ///
+    /// The elements are appended, then the appended nodes and their
+    /// ancestors are sifted down, a level at a time from the bottom, in
+    /// descending order so that the children of a node are heaps when it
+    /// is sifted; into an empty heap this is Floyd's linear construction
+    template<typename I>
+    void heapify(I b, I e) {
+        std::size_t lo = size();
+        storage_.insert(storage_.end(), b, e);
+        auto count = size();
+        if(count <= lo) { return; }
+        std::size_t hi = count - 1, below = count;
+        for(;;) {
+            auto highest = std::min(hi, below - 1);
+            for(auto ndx = highest + 1; lo < ndx; ) {
+                --ndx;
+                siftDown(ndx, std::move(data()[ndx]));
+            }
+            below = std::min(below, lo);
+            if(0 == lo) { break; }
+            lo = (lo - 1) / D;
+            hi = (hi - 1) / D;
+        }
+    }
+};
+
+/// \brief Whether no element of the D-ary heap [b, e) compares less than
+/// its parent; otherwise, the location of the first such element
+template<int D, typename I, typename Comparator = Less>
+auto validDaryHeap(I b, I e, Comparator c = Comparator{}) -> ValidResult {
+    long count = e - b;
+    for(long ndx = 1; ndx < count; ++ndx) {
+        if(c(*(b + ndx), *(b + (ndx - 1) / D))) { return {false, ndx}; }
+    }
+    return {true, 0};
+}
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef ZOO_DEDUPLICATED_CFS
+#define ZOO_DEDUPLICATED_CFS
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <utility>
+#include <vector>
+#endif
+
+namespace zoo {
+
+/// \brief CFS layout of the distinct keys of a sorted sequence, with the
+/// run of each key in the sequence in a parallel array
+///
+/// For data with heavy repetitions the layout is as small as the count of
+/// distinct keys, and the equal range of a key is a single descent; the
+/// ranges are positions in the sorted sequence, to slice a payload sorted
+/// alike
+template<typename K, typename Compare = Less>
+class DeduplicatedCFS {
+    struct Run {
+        std::size_t offset, count;
+    };
+
+    std::vector<K> keys_;
+    std::vector<Run> runs_;
+    std::size_t size_ = 0;
+    Compare compare_;
+
+public:
+    DeduplicatedCFS() = default;
+
+    /// \brief From the sorted range [begin, end)
+    template<typename I>
+    DeduplicatedCFS(I begin, I end, Compare c = Compare{}): compare_{c} {
+        std::vector<K> distinct;
+        std::vector<Run> runs;
+        while(end != begin) {
+            auto runEnd = begin;
+            std::size_t count = 0;
+            do {
+                ++runEnd;
+                ++count;
+            } while(end != runEnd && not c(*begin, *runEnd));
+            distinct.push_back(*begin);
+            runs.push_back({size_, count});
+            size_ += count;
+            begin = runEnd;
+        }
+        keys_.reserve(distinct.size());
+        runs_.reserve(runs.size());
+        transformToCFS(back_inserter(keys_), distinct.begin(), distinct.end());
+        transformToCFS(back_inserter(runs_), runs.begin(), runs.end());
+    }
+
+    /// \brief The count of elements of the sorted sequence
+    std::size_t size() const noexcept { return size_; }
+    std::size_t distinct() const noexcept { return keys_.size(); }
+
+    /// \brief The distinct keys, in CFS order
+    auto begin() const noexcept { return keys_.data(); }
+    auto end() const noexcept { return keys_.data() + keys_.size(); }
+
+    /// \brief The positions [first, second) of the elements equivalent to
+    /// \c k in the sorted sequence; empty at the position of the lower
+    /// bound if there are none
+    template<typename E>
+    std::pair<std::size_t, std::size_t> equalRange(const E &k) const {
+        auto b = begin(), e = end();
+        auto where = cfsLowerBound(b, e, k, compare_);
+        if(e == where) { return {size_, size_}; }
+        auto &run = runs_[where - b];
+        auto c = compare_;
+        if(c(k, *where)) { return {run.offset, run.offset}; }
+        return {run.offset, run.offset + run.count};
+    }
+
+    template<typename E>
+    std::size_t lowerBound(const E &k) const { return equalRange(k).first; }
+
+    template<typename E>
+    std::size_t count(const E &k) const {
+        auto range = equalRange(k);
+        return range.second - range.first;
+    }
+};
+
+}
+
+#endif
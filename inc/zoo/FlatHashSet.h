@@ -0,0 +1,254 @@
+#ifndef ZOO_FLAT_HASH_SET
+#define ZOO_FLAT_HASH_SET
+
+#include <zoo/AlignedAllocator.h>
+#include <zoo/util/hash_mix.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <vector>
+#endif
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace zoo {
+
+/// \brief Open addressing hash set of small keys in a flat array, probed a
+/// group of 16 slots at a time
+///
+/// Each slot has a control byte, negative for the empty and the deleted
+/// slots, otherwise the low 7 bits of the hash of its key; the high bits
+/// select the group where the probing starts.  The control bytes of a group
+/// are compared with a single SSE2 instruction, so the keys compared are
+/// almost only the equal ones.  Probing stops at a group with an empty
+/// slot, the load is kept below 7/8 so there is always one.
+///
+/// Meant for keys such as integers: \c T is default constructible and the
+/// keys are stored by value, erasure does not destroy them.
+template<
+    typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>
+>
+class FlatHashSet {
+    constexpr static std::size_t GroupSize = 16;
+    constexpr static signed char Empty = -128, Deleted = -2;
+    constexpr static auto NotFound = ~std::size_t(0);
+
+    std::vector<signed char, AlignedAllocator<signed char>> control_;
+    std::vector<T> slots_;
+    std::size_t size_ = 0, tombstones_ = 0;
+    Hash hash_;
+    Equal equal_;
+
+    /// \brief Bit i is set if byte i of the group is \c byte
+    static std::uint32_t match(const signed char *group, signed char byte) {
+        #if defined(__SSE2__)
+        auto bytes = _mm_load_si128(reinterpret_cast<const __m128i *>(group));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(byte)));
+        #else
+        std::uint32_t rv = 0;
+        for(std::size_t ndx = 0; ndx < GroupSize; ++ndx) {
+            rv |= std::uint32_t(byte == group[ndx]) << ndx;
+        }
+        return rv;
+        #endif
+    }
+
+    /// \brief Bit i is set if slot i of the group is empty or deleted
+    static std::uint32_t matchFree(const signed char *group) {
+        #if defined(__SSE2__)
+        return _mm_movemask_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(group))
+        );
+        #else
+        std::uint32_t rv = 0;
+        for(std::size_t ndx = 0; ndx < GroupSize; ++ndx) {
+            rv |= std::uint32_t(group[ndx] < 0) << ndx;
+        }
+        return rv;
+        #endif
+    }
+
+    std::uint64_t hashOf(const T &k) const { return mixHash(hash_(k)); }
+
+    /// \brief Visits the groups of the probe sequence of \c hash until
+    /// \c callable returns true; triangular steps visit all the groups
+    /// since their count is a power of two
+    template<typename Callable>
+    void probe(std::uint64_t hash, Callable &&callable) const {
+        auto mask = capacity() / GroupSize - 1;
+        auto group = (hash >> 7) & mask;
+        for(std::size_t step = 1; !callable(group * GroupSize); ++step) {
+            group = (group + step) & mask;
+        }
+    }
+
+    std::size_t findIndex(const T &k, std::uint64_t hash) const {
+        auto rv = NotFound;
+        if(slots_.empty()) { return rv; }
+        auto fragment = static_cast<signed char>(hash & 0x7f);
+        probe(hash, [&](std::size_t first) {
+            auto group = control_.data() + first;
+            for(auto candidates = match(group, fragment); candidates; ) {
+                auto ndx = first + __builtin_ctz(candidates);
+                if(equal_(slots_[ndx], k)) {
+                    rv = ndx;
+                    return true;
+                }
+                candidates &= candidates - 1;
+            }
+            return 0 != match(group, Empty);
+        });
+        return rv;
+    }
+
+    /// \pre the key is not in the set and there is room
+    void place(const T &k, std::uint64_t hash) {
+        probe(hash, [&](std::size_t first) {
+            auto free = matchFree(control_.data() + first);
+            if(!free) { return false; }
+            auto ndx = first + __builtin_ctz(free);
+            if(Deleted == control_[ndx]) { --tombstones_; }
+            control_[ndx] = static_cast<signed char>(hash & 0x7f);
+            slots_[ndx] = k;
+            ++size_;
+            return true;
+        });
+    }
+
+    void rehash(std::size_t newCapacity) {
+        auto oldControl = std::move(control_);
+        auto oldSlots = std::move(slots_);
+        control_.assign(newCapacity, Empty);
+        slots_.assign(newCapacity, T{});
+        size_ = tombstones_ = 0;
+        for(std::size_t ndx = 0; ndx < oldSlots.size(); ++ndx) {
+            if(0 <= oldControl[ndx]) {
+                place(oldSlots[ndx], hashOf(oldSlots[ndx]));
+            }
+        }
+    }
+
+public:
+    struct const_iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const signed char *control_, *controlEnd_;
+        const T *slot_;
+
+        void skipFree() {
+            while(controlEnd_ != control_ && *control_ < 0) {
+                ++control_;
+                ++slot_;
+            }
+        }
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+
+        const_iterator &operator++() {
+            ++control_;
+            ++slot_;
+            skipFree();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto rv = *this;
+            ++*this;
+            return rv;
+        }
+
+        bool operator==(const const_iterator &other) const {
+            return slot_ == other.slot_;
+        }
+        bool operator!=(const const_iterator &other) const {
+            return slot_ != other.slot_;
+        }
+    };
+    using iterator = const_iterator;
+
+    FlatHashSet() = default;
+
+    /// \brief The set of the keys in [begin, end)
+    template<typename I>
+    FlatHashSet(I begin, I end) {
+        reserve(std::distance(begin, end));
+        for(; begin != end; ++begin) { insert(*begin); }
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return !size_; }
+    std::size_t capacity() const noexcept { return slots_.size(); }
+
+    /// \brief Makes room for \c count keys without rehashing
+    void reserve(std::size_t count) {
+        std::size_t newCapacity = GroupSize;
+        while(newCapacity / 8 * 7 < count + 1) { newCapacity *= 2; }
+        if(capacity() < newCapacity) { rehash(newCapacity); }
+    }
+
+    const_iterator begin() const noexcept {
+        auto control = control_.data();
+        const_iterator rv{control, control + capacity(), slots_.data()};
+        rv.skipFree();
+        return rv;
+    }
+
+    const_iterator end() const noexcept {
+        auto controlEnd = control_.data() + capacity();
+        return {controlEnd, controlEnd, slots_.data() + capacity()};
+    }
+
+    const_iterator find(const T &k) const {
+        auto ndx = findIndex(k, hashOf(k));
+        if(NotFound == ndx) { return end(); }
+        auto controlEnd = control_.data() + capacity();
+        return {control_.data() + ndx, controlEnd, slots_.data() + ndx};
+    }
+
+    bool contains(const T &k) const {
+        return NotFound != findIndex(k, hashOf(k));
+    }
+
+    /// \returns whether the key was not already in the set
+    bool insert(const T &k) {
+        auto hash = hashOf(k);
+        if(NotFound != findIndex(k, hash)) { return false; }
+        if(capacity() / 8 * 7 < size_ + tombstones_ + 1) {
+            // rehashing in place only clears the tombstones
+            auto newCapacity = capacity() ? capacity() : GroupSize;
+            if(newCapacity / 16 * 7 < size_ + 1) { newCapacity *= 2; }
+            rehash(newCapacity);
+        }
+        place(k, hash);
+        return true;
+    }
+
+    /// \returns whether the key was in the set
+    bool erase(const T &k) {
+        auto ndx = findIndex(k, hashOf(k));
+        if(NotFound == ndx) { return false; }
+        // no probe passed a group with an empty slot, the slot may be empty
+        auto group = control_.data() + ndx / GroupSize * GroupSize;
+        if(match(group, Empty)) {
+            control_[ndx] = Empty;
+        } else {
+            control_[ndx] = Deleted;
+            ++tombstones_;
+        }
+        --size_;
+        return true;
+    }
+};
+
+}
+
+#endif
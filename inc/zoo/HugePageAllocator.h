@@ -0,0 +1,100 @@
+#ifndef ZOO_HUGE_PAGE_ALLOCATOR
+#define ZOO_HUGE_PAGE_ALLOCATOR
+
+#ifndef SIMPLIFY_INCLUDES
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#endif
+
+#include <sys/mman.h>
+
+namespace zoo {
+
+/// \brief Allocator for large buffers backed by huge pages, to reduce the
+/// misses of the TLB of the lower levels of large search structures
+///
+/// Allocations of at least a huge page are whole huge pages: first,
+/// explicit huge pages are requested, if there are none reserved in the
+/// system, the mapping is of normal pages aligned to the huge page, for
+/// which transparent huge pages are requested with \c madvise.  Smaller
+/// allocations are of cache line aligned memory.
+template<typename T>
+struct HugePageAllocator {
+    constexpr static std::size_t HugePage = std::size_t(2) << 20;
+    constexpr static std::size_t SmallAlignment = 64;
+
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = HugePageAllocator<U>; };
+
+    HugePageAllocator() = default;
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U> &) noexcept {}
+
+    /// \brief The most elements whose mapping, rounded up and over-mapped
+    /// by a huge page for alignment, does not overflow
+    constexpr static std::size_t max_size() noexcept {
+        return (~std::size_t(0) - 2 * HugePage) / sizeof(T);
+    }
+
+    static std::size_t mappingSize(std::size_t n) noexcept {
+        return (n * sizeof(T) + HugePage - 1) & ~(HugePage - 1);
+    }
+
+    T *allocate(std::size_t n) {
+        if(max_size() < n) { throw std::bad_array_new_length{}; }
+        if(n * sizeof(T) < HugePage) {
+            return static_cast<T *>(
+                ::operator new(n * sizeof(T), std::align_val_t{SmallAlignment})
+            );
+        }
+        auto size = mappingSize(n);
+        constexpr auto Protection = PROT_READ | PROT_WRITE;
+        constexpr auto Flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        #ifdef MAP_HUGETLB
+        auto explicitHuge =
+            ::mmap(nullptr, size, Protection, Flags | MAP_HUGETLB, -1, 0);
+        if(MAP_FAILED != explicitHuge) {
+            return static_cast<T *>(explicitHuge);
+        }
+        #endif
+        // over-maps by a huge page to trim to the alignment
+        auto raw = ::mmap(nullptr, size + HugePage, Protection, Flags, -1, 0);
+        if(MAP_FAILED == raw) { throw std::bad_alloc{}; }
+        auto address = reinterpret_cast<std::uintptr_t>(raw);
+        auto aligned = (address + HugePage - 1) & ~(HugePage - 1);
+        auto head = aligned - address;
+        if(head) { ::munmap(raw, head); }
+        auto tail = HugePage - head;
+        if(tail) { ::munmap(reinterpret_cast<void *>(aligned + size), tail); }
+        auto rv = reinterpret_cast<void *>(aligned);
+        #ifdef MADV_HUGEPAGE
+        // only advice, the pages may still be normal
+        ::madvise(rv, size, MADV_HUGEPAGE);
+        #endif
+        return static_cast<T *>(rv);
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        if(n * sizeof(T) < HugePage) {
+            ::operator delete(p, std::align_val_t{SmallAlignment});
+            return;
+        }
+        ::munmap(p, mappingSize(n));
+    }
+
+    template<typename U>
+    bool operator==(const HugePageAllocator<U> &) const noexcept {
+        return true;
+    }
+    template<typename U>
+    bool operator!=(const HugePageAllocator<U> &) const noexcept {
+        return false;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef ZOO_LEARNED_INDEX
+#define ZOO_LEARNED_INDEX
+
+#ifndef SIMPLIFY_INCLUDES
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+namespace zoo {
+
+/// \brief Sorted array of arithmetic keys searched by predicting positions
+/// with a piecewise linear model of the keys to their positions
+///
+/// The model is fit so that the position predicted for each key is within
+/// \c error of its first occurrence; the search then only has to look in
+/// a window around the prediction.  For near uniform keys, as those of
+/// random samples, a handful of segments suffices, much less memory than
+/// the inner nodes of a search tree.  The interface mirrors that of the
+/// CFS searches: iterators to the keys in sorted order.
+/// \note Unlike the CFS searches there is no comparator: the model maps
+/// the numeric values of the keys to positions, which requires the keys
+/// sorted ascending by \c operator<
+template<typename T>
+class LearnedIndex {
+    static_assert(std::is_arithmetic_v<T>, "keys are modeled as numbers");
+
+    struct Segment {
+        T firstKey;
+        double slope;
+        std::size_t start;
+    };
+
+    std::vector<T> keys_;
+    std::vector<Segment> segments_;
+    std::size_t error_;
+
+    /// Shrinking cone: the slopes of the lines through the first point of
+    /// the segment within error of all the points so far
+    void fit() {
+        auto size = keys_.size();
+        std::size_t start = 0;
+        double low = 0, high = std::numeric_limits<double>::infinity();
+        auto close = [&]() {
+            auto slope =
+                high == std::numeric_limits<double>::infinity() ?
+                    low : (low + high) / 2;
+            segments_.push_back({keys_[start], slope, start});
+        };
+        for(std::size_t ndx = 1; ndx < size; ++ndx) {
+            // only the first occurrence of each key is modeled
+            if(not(keys_[ndx - 1] < keys_[ndx])) { continue; }
+            auto dx = double(keys_[ndx]) - double(keys_[start]);
+            auto dy = double(ndx - start);
+            auto newLow = std::max(low, (dy - error_) / dx);
+            auto newHigh = std::min(high, (dy + error_) / dx);
+            if(newHigh < newLow) {
+                close();
+                start = ndx;
+                low = 0;
+                high = std::numeric_limits<double>::infinity();
+                continue;
+            }
+            low = newLow;
+            high = newHigh;
+        }
+        if(size) { close(); }
+        segments_.shrink_to_fit();
+    }
+
+public:
+    LearnedIndex() = default;
+
+    /// \brief From the sorted range [begin, end)
+    /// \param error the bound of the distance between the predicted and
+    /// the actual positions of the keys
+    template<typename I>
+    LearnedIndex(I begin, I end, std::size_t error = 32):
+        keys_(begin, end), error_{error}
+    {
+        fit();
+    }
+
+    const T *begin() const noexcept { return keys_.data(); }
+    const T *end() const noexcept { return keys_.data() + keys_.size(); }
+    std::size_t size() const noexcept { return keys_.size(); }
+    std::size_t segments() const noexcept { return segments_.size(); }
+
+    /// \brief The memory of the model, on top of that of the keys
+    std::size_t modelBytes() const noexcept {
+        return segments_.size() * sizeof(Segment);
+    }
+
+    const T *lowerBound(const T &v) const {
+        auto b = begin();
+        auto next =
+            std::upper_bound(
+                segments_.begin(), segments_.end(), v,
+                [](const T &v, const Segment &s) { return v < s.firstKey; }
+            );
+        if(segments_.begin() == next) { return b; }
+        auto &segment = *(next - 1);
+        // the bound is past the first key of the segment and not past the
+        // first of the next
+        auto segmentBegin = segment.start;
+        auto segmentEnd = segments_.end() == next ? size() : next->start;
+        auto predicted =
+            segmentBegin +
+            segment.slope * (double(v) - double(segment.firstKey));
+        auto position =
+            std::size_t(
+                std::min(std::max(predicted, double(segmentBegin)),
+                double(segmentEnd))
+            );
+        auto low =
+            segmentBegin + error_ + 1 < position ?
+                position - error_ - 1 : segmentBegin;
+        auto high = std::min(position + error_ + 2, segmentEnd);
+        auto rv = std::lower_bound(b + low, b + high, v);
+        // keys not in the index, or repeated, may be farther than the error
+        if(b + high == rv && high < segmentEnd) {
+            rv = std::lower_bound(b + high, b + segmentEnd, v);
+        } else if(b + low == rv && segmentBegin < low && not(b[low - 1] < v)) {
+            rv = std::lower_bound(b + segmentBegin, b + low, v);
+        }
+        return rv;
+    }
+
+    std::pair<const T *, const T *> equalRange(const T &v) const {
+        auto lower = lowerBound(v), e = end();
+        // gallops over the repetitions
+        auto equal = lower, higher = lower;
+        for(std::size_t step = 1; e != higher && not(v < *higher); step *= 2) {
+            equal = higher;
+            higher = std::size_t(e - higher) <= step ? e : higher + step;
+        }
+        return {lower, std::upper_bound(equal, higher, v)};
+    }
+};
+
+}
+
+#endif
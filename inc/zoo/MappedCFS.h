@@ -0,0 +1,233 @@
+#ifndef ZOO_MAPPED_CFS
+#define ZOO_MAPPED_CFS
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <iterator>
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace zoo {
+
+/// \brief The header of the file format of a CFS index, the payload of
+/// \c count elements in CFS order starts at \c payloadOffset
+///
+/// All fields are in the byte order of the machine that wrote them, a
+/// reader on a machine of the other order fails on the magic number
+struct CfsFileHeader {
+    constexpr static std::uint64_t Magic = 0x5346436f6f7aull; // "zooCFS"
+    constexpr static std::uint32_t CurrentVersion = 1;
+
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t elementSize;
+    std::uint64_t count;
+    /// \brief Chosen by the user to identify the ordering of the elements,
+    /// the reader checks it matches
+    std::uint64_t comparatorTag;
+    std::uint32_t alignment;
+    std::uint32_t payloadOffset;
+};
+
+namespace detail {
+
+[[noreturn]] inline void throwSystemError(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/// \brief Output iterator that writes the bytes of the elements to a file
+template<typename T>
+struct CfsFileOutput {
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    std::FILE *file_;
+
+    CfsFileOutput &operator*() noexcept { return *this; }
+    CfsFileOutput &operator++() noexcept { return *this; }
+    CfsFileOutput &operator++(int) noexcept { return *this; }
+
+    CfsFileOutput &operator=(const T &element) {
+        if(1 != std::fwrite(&element, sizeof(T), 1, file_)) {
+            throwSystemError("writing CFS payload");
+        }
+        return *this;
+    }
+};
+
+}
+
+/// \brief Writes the sorted range [begin, end) to the file at \c path in
+/// CFS order, preceded by a \c CfsFileHeader
+///
+/// \param alignment of the payload within the file, since mappings begin
+/// at page boundaries the default makes the payload cache line aligned
+/// \pre alignment is a power of two
+template<typename Input>
+void writeCFSFile(
+    const char *path, Input begin, Input end,
+    std::uint64_t comparatorTag = 0, std::uint32_t alignment = 64
+) {
+    using T = typename std::iterator_traits<Input>::value_type;
+    static_assert(std::is_trivially_copyable_v<T>, "T is written as bytes");
+    if(0 == alignment || (alignment & (alignment - 1))) {
+        throw std::invalid_argument("CFS file alignment not a power of two");
+    }
+    if(alignment < alignof(T)) { alignment = alignof(T); }
+    CfsFileHeader header{
+        CfsFileHeader::Magic, CfsFileHeader::CurrentVersion,
+        sizeof(T), std::uint64_t(end - begin), comparatorTag,
+        alignment,
+        std::uint32_t(
+            (sizeof(CfsFileHeader) + alignment - 1) / alignment * alignment
+        )
+    };
+    auto file = std::fopen(path, "wb");
+    if(!file) { detail::throwSystemError("opening CFS file for writing"); }
+    try {
+        char padding[1024] = {};
+        auto paddingSize = header.payloadOffset - sizeof(CfsFileHeader);
+        if(sizeof(padding) < paddingSize) {
+            throw std::invalid_argument("CFS file alignment too large");
+        }
+        if(
+            1 != std::fwrite(&header, sizeof(header), 1, file) ||
+            paddingSize != std::fwrite(padding, 1, paddingSize, file)
+        ) {
+            detail::throwSystemError("writing CFS header");
+        }
+        transformToCFS(detail::CfsFileOutput<T>{file}, begin, end);
+        if(std::fclose(file)) {
+            file = nullptr;
+            detail::throwSystemError("closing CFS file");
+        }
+    } catch(...) {
+        if(file) { std::fclose(file); }
+        throw;
+    }
+}
+
+/// \brief Read-only memory mapping of a file written by \c writeCFSFile
+///
+/// The elements are not parsed nor copied, [begin(), end()) is the payload
+/// in CFS order, usable directly by \c cfsLowerBound and the other
+/// searches; the pages are loaded by the searches that touch them
+template<typename T>
+class MappedCFS {
+    static_assert(std::is_trivially_copyable_v<T>, "T is read as bytes");
+
+    void *mapping_ = nullptr;
+    std::size_t mappingSize_ = 0;
+    const T *begin_ = nullptr;
+    std::size_t count_ = 0;
+
+    void release() noexcept {
+        if(mapping_) { ::munmap(mapping_, mappingSize_); }
+    }
+
+public:
+    MappedCFS(const char *path, std::uint64_t comparatorTag = 0) {
+        auto fd = ::open(path, O_RDONLY);
+        if(fd < 0) { detail::throwSystemError("opening CFS file"); }
+        struct stat status;
+        if(::fstat(fd, &status)) {
+            ::close(fd);
+            detail::throwSystemError("inspecting CFS file");
+        }
+        mappingSize_ = status.st_size;
+        if(mappingSize_ < sizeof(CfsFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("CFS file too small for the header");
+        }
+        mapping_ = ::mmap(nullptr, mappingSize_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(MAP_FAILED == mapping_) {
+            mapping_ = nullptr;
+            detail::throwSystemError("mapping CFS file");
+        }
+        CfsFileHeader header;
+        std::memcpy(&header, mapping_, sizeof(header));
+        const char *failure = nullptr;
+        if(CfsFileHeader::Magic != header.magic) {
+            failure = "not a CFS file";
+        } else if(CfsFileHeader::CurrentVersion != header.version) {
+            failure = "unsupported CFS file version";
+        } else if(sizeof(T) != header.elementSize) {
+            failure = "CFS file element size mismatch";
+        } else if(comparatorTag != header.comparatorTag) {
+            failure = "CFS file comparator mismatch";
+        } else if(
+            header.payloadOffset < sizeof(CfsFileHeader) ||
+            mappingSize_ < header.payloadOffset
+        ) {
+            failure = "CFS file payload offset out of bounds";
+        } else if(
+            0 == header.alignment ||
+            (header.alignment & (header.alignment - 1)) ||
+            header.alignment < alignof(T) ||
+            header.payloadOffset % header.alignment
+        ) {
+            failure = "CFS file payload misaligned";
+        } else if(
+            (mappingSize_ - header.payloadOffset) / sizeof(T) < header.count
+        ) {
+            failure = "CFS file payload truncated";
+        }
+        if(failure) {
+            release();
+            throw std::runtime_error(failure);
+        }
+        begin_ =
+            reinterpret_cast<const T *>(
+                static_cast<const char *>(mapping_) + header.payloadOffset
+            );
+        count_ = header.count;
+    }
+
+    MappedCFS(const MappedCFS &) = delete;
+    MappedCFS &operator=(const MappedCFS &) = delete;
+
+    MappedCFS(MappedCFS &&model) noexcept:
+        mapping_{model.mapping_}, mappingSize_{model.mappingSize_},
+        begin_{model.begin_}, count_{model.count_}
+    {
+        model.mapping_ = nullptr;
+    }
+
+    MappedCFS &operator=(MappedCFS &&model) noexcept {
+        if(this != &model) {
+            release();
+            mapping_ = model.mapping_;
+            mappingSize_ = model.mappingSize_;
+            begin_ = model.begin_;
+            count_ = model.count_;
+            model.mapping_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~MappedCFS() { release(); }
+
+    const T *begin() const noexcept { return begin_; }
+    const T *end() const noexcept { return begin_ + count_; }
+    std::size_t size() const noexcept { return count_; }
+};
+
+}
+
+#endif
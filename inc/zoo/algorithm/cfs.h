@@ -2,12 +2,19 @@
 #define ZOO_CFS_CACHE_FRIENDLY_SEARCH
 
 #include <zoo/algorithm/less.h>
+#include <zoo/algorithm/moveRotation.h>
 
 #ifndef SIMPLIFY_INCLUDES
 // because of std::declval needed to default comparator
 #include <utility>
 // because of std::decay needed to decay deferenced iterator
 #include <type_traits>
+// because of std::rotate needed by the in-place transformation
+#include <algorithm>
+// because of std::iterator_traits needed by the in-order iterator
+#include <iterator>
+// because of std::array needed by the compile time tables
+#include <array>
 #endif
 
 namespace zoo {
@@ -21,7 +28,7 @@ constexpr unsigned long long log2Ceiling(unsigned long long arg) {
 }
 
 template<typename Output, typename Input>
-void transformToCFS(Output output, Input base, Input end) {
+constexpr void transformToCFS(Output output, Input base, Input end) {
     auto s = end - base;
     auto logP = log2Floor(s + 1); // n
     auto power2 = 1ul << logP;
@@ -57,6 +64,186 @@ void transformToCFS(Output output, Input base, Input end) {
     }
 }
 
+/// \brief The CFS layout of \c sorted, usable in constant expressions so
+/// that static tables are laid out at compile time
+/// \pre \c sorted is sorted
+template<typename T, std::size_t Size>
+constexpr std::array<T, Size> makeCFS(const std::array<T, Size> &sorted) {
+    std::array<T, Size> rv{};
+    transformToCFS(rv.begin(), sorted.begin(), sorted.end());
+    return rv;
+}
+
+namespace detail {
+
+/// \brief The position in sorted order of the element at index \c ndx of
+/// the CFS layout of \c size elements
+///
+/// In the perfect tree of the same height, the node k == ndx + 1 at depth d
+/// is preceded in order by (2*(k - 2^d) + 1)*2^(height - d) - 1 nodes; of
+/// those, the slots of the last level the tree does not have are removed
+/// \pre ndx < size
+constexpr std::size_t cfsSortedIndex(std::size_t size, std::size_t ndx) {
+    auto lastLevel = log2Floor(size);
+    auto k = ndx + 1;
+    auto depth = log2Floor(k);
+    auto perfect =
+        ((((k - (1ull << depth)) << 1) + 1) << (lastLevel - depth)) - 1;
+    auto leaves = size + 1 - (1ull << lastLevel);
+    // the slots of the last level occupy the even positions of the perfect
+    // tree
+    auto precedingSlots = (perfect + 1) >> 1;
+    return
+        precedingSlots <= leaves ?
+            perfect :
+            perfect - (precedingSlots - leaves);
+}
+
+/// \brief Inverse of \c cfsSortedIndex: the index in the CFS layout of
+/// \c size elements of the element at position \c sorted in sorted order
+/// \pre sorted < size
+constexpr std::size_t cfsLayoutIndex(std::size_t size, std::size_t sorted) {
+    auto lastLevel = log2Floor(size);
+    auto leaves = size + 1 - (1ull << lastLevel);
+    // past the leaves, only the odd positions of the perfect tree exist
+    auto perfect =
+        sorted < (leaves << 1) ? sorted : ((sorted - leaves) << 1) + 1;
+    auto heightBelow = __builtin_ctzll(perfect + 1);
+    auto depth = lastLevel - heightBelow;
+    return (1ull << depth) + ((perfect + 1) >> (heightBelow + 1)) - 1;
+}
+
+}
+
+namespace detail {
+
+/// \brief Stable partition of [base, base + size) into the elements at odd
+/// positions followed by the elements at even positions
+///
+/// Recursively deinterleaves both halves, [O1 E1][O2 E2], and rotates
+/// [E1 O2] into [O2 E1]: O(size log size) moves, O(log size) stack
+template<typename I>
+void cfsDeinterleave(I base, std::size_t size) {
+    if(size < 3) {
+        if(2 == size) { moveRotation(*base, *(base + 1)); }
+        return;
+    }
+    // the split point is even so that the parities of the second half hold
+    auto split = ((size >> 1) + 1) & ~std::size_t(1);
+    cfsDeinterleave(base, split);
+    cfsDeinterleave(base + split, size - split);
+    auto higherOdds = (size - split) >> 1;
+    std::rotate(base + (split >> 1), base + split, base + split + higherOdds);
+}
+
+}
+
+/// \brief Permutes the sorted range [base, end) into CFS order, without
+/// another buffer
+///
+/// In sorted order, the leaves of the last level are the even positions
+/// up to twice their count; moving them to the end leaves a perfect tree,
+/// whose leaves are all of its even positions, and so on.
+/// Requires O(n log n) moves and O(log n) stack
+template<typename I>
+void transformToCFSInPlace(I base, I end) {
+    std::size_t size = end - base;
+    if(size < 2) { return; }
+    auto lastLevel = log2Floor(size);
+    auto leaves = size + 1 - (1ull << lastLevel);
+    auto prefix = std::min<std::size_t>(leaves << 1, size);
+    detail::cfsDeinterleave(base, prefix);
+    std::rotate(base + (prefix >> 1), base + prefix, end);
+    for(auto perfect = size - leaves; 1 < perfect; perfect >>= 1) {
+        detail::cfsDeinterleave(base, perfect);
+    }
+}
+
+namespace detail {
+
+/// \brief Partitions the elements of sorted positions [lower, higher) as
+/// quicksort does, but as soon as the sorted position of a pivot is known
+/// it is written to its CFS position; the sorted order is then only
+/// materialized in the small partitions, which are sorted and scattered
+///
+/// A partition much smaller than expected may be due to a run of elements
+/// equivalent to the pivot, which are then gathered and written as well.
+/// As introsort, when the partitions are too unbalanced for \c depthBudget
+/// the rest is sorted
+template<
+    std::size_t SmallPartition,
+    typename I, typename Output, typename Comparator
+>
+void sortToCFSPartition(
+    I base, std::size_t size,
+    std::size_t lower, std::size_t higher,
+    Output output, Comparator c, int depthBudget
+) {
+    auto place = [&](std::size_t sorted) {
+        *(output + cfsLayoutIndex(size, sorted)) = *(base + sorted);
+    };
+    while(SmallPartition < higher - lower && depthBudget--) {
+        auto first = base + lower, last = base + higher;
+        auto middle = first + ((higher - lower) >> 1);
+        // median of three to the front
+        if(c(*middle, *first)) { std::iter_swap(middle, first); }
+        if(c(*(last - 1), *middle)) {
+            std::iter_swap(middle, last - 1);
+            if(c(*middle, *first)) { std::iter_swap(middle, first); }
+        }
+        std::iter_swap(first, middle);
+        auto &pivot = *first;
+        auto lowerEnd =
+            std::partition(
+                first + 1, last, [&](const auto &x) { return c(x, pivot); }
+            );
+        std::iter_swap(first, --lowerEnd);
+        auto pivotPosition = std::size_t(lowerEnd - base);
+        auto higherBegin = pivotPosition + 1;
+        if(pivotPosition - lower < ((higher - lower) >> 3)) {
+            auto &p = *(base + pivotPosition);
+            auto equivalentEnd =
+                std::partition(
+                    base + higherBegin, last,
+                    [&](const auto &x) { return not c(p, x); }
+                );
+            auto equivalentsEnd = std::size_t(equivalentEnd - base);
+            while(higherBegin < equivalentsEnd) { place(higherBegin++); }
+        }
+        place(pivotPosition);
+        if(pivotPosition - lower < higher - higherBegin) {
+            sortToCFSPartition<SmallPartition>(
+                base, size, lower, pivotPosition, output, c, depthBudget
+            );
+            lower = higherBegin;
+        } else {
+            sortToCFSPartition<SmallPartition>(
+                base, size, higherBegin, higher, output, c, depthBudget
+            );
+            higher = pivotPosition;
+        }
+    }
+    std::sort(base + lower, base + higher, c);
+    for(auto sorted = lower; sorted < higher; ++sorted) { place(sorted); }
+}
+
+}
+
+/// \brief Writes the elements of the unsorted range [base, end) to
+/// \c output in CFS order, without transforming a sorted copy afterwards
+///
+/// \pre the output is random access, with end - base elements
+/// \post [base, end) is sorted
+template<typename I, typename Output, typename Comparator = Less>
+void sortToCFS(I base, I end, Output output, Comparator c = Comparator{}) {
+    std::size_t size = end - base;
+    if(0 == size) { return; }
+    auto depthBudget = 2 * int(log2Floor(size)) + 2;
+    detail::sortToCFSPartition<16>(
+        base, size, 0, size, output, c, depthBudget
+    );
+}
+
 namespace detail {
 
 enum SearchPolicy {
@@ -68,7 +255,7 @@ enum SearchPolicy {
 template<
     SearchPolicy Policy, typename Base, typename E, typename Comparator
 >
-auto cfsBound(
+constexpr auto cfsBound(
     Base base,
     Base supremum,
     std::size_t size, std::size_t ndx,
@@ -101,41 +288,66 @@ auto cfsBound(
     }
     if(RANGE != Policy) { return {infimum, infimum}; }
 
-    // Assumes streaks of equivalent elements are much less than the size
-    //
-    // Looking for the end of the streak of equivalent elements to e.
-    // In the case ndx is a left subtree, we have
-    // e <= base[ndx] <= base[parent(ndx)]
-    // if e < base[parent(ndx)] the upper bound is in
-    // [successor(ndx), parent(ndx)]
-    ndx = infimum - base;
-    while(1 & ndx) {
-        auto parent = ndx >> 1;
-        auto current = base + parent;
-        auto &cmp = *current;        
-        if(c(e, cmp)) {
-            supremum = base + parent;
-            break;
-        }
-        ndx = parent;
-    }
-    // Either there is no parent, or the parent is an upper bound, the supremum
-    // can only be in the higher subtree of ndx
+    // The higher bound from the root again: climbing from the lower bound
+    // to the end of the streak of equivalent elements costs as much as the
+    // streak is long, and with heavy repetitions the streaks are long
     auto upper =
-        cfsBound<ONLY_UPPER_BOUND>(
-            base, supremum, size, (ndx << 1) + 2, e, c
-        ).first;
+        cfsBound<ONLY_UPPER_BOUND>(base, supremum, size, 0, e, c).first;
     return {infimum, upper};
 }
 
+/// \brief Descends the full height using the one-based index
+/// k == ndx + 1, in which the next index is 2k + goHigher
+///
+/// When the descent falls off the tree, the trailing ones of k are the
+/// steps taken to the higher subtrees after the last node that was not
+/// less than the key, removing them and the zero for that last step
+/// recovers the node
+template<
+    int PrefetchDistance, SearchPolicy Policy,
+    typename Base, typename E, typename Comparator
+>
+Base cfsBoundBranchFree(Base base, Base end, const E &e, Comparator c) {
+    static_assert(RANGE != Policy, "only bounds are supported");
+    unsigned long long size = end - base, k = 1;
+    while(k <= size) {
+        if constexpr(0 < PrefetchDistance) {
+            // forming a pointer past the end is undefined even to prefetch,
+            // the last levels are not prefetched
+            auto ahead = (k << PrefetchDistance) - 1;
+            if(ahead < size) { __builtin_prefetch(&*base + ahead); }
+        }
+        auto &cmp = *(base + (k - 1));
+        bool goHigher =
+            ONLY_UPPER_BOUND == Policy ? not c(e, cmp) : c(cmp, e);
+        k = (k << 1) + goHigher;
+    }
+    k >>= __builtin_ffsll(~k);
+    return k ? base + (k - 1) : end;
+}
+
 }
 
+/// \brief Search policy tag of the descent that may end early
+struct Branching {};
+
+/// \brief Search policy tag of the descent without branches on the
+/// comparisons
+///
+/// \tparam PrefetchDistance how many levels ahead to prefetch, the
+/// descendants of a node at that distance are contiguous; 0 disables
+/// prefetching, otherwise the elements must be contiguous in memory
+template<int PrefetchDistance = 4>
+struct BranchFree {};
+
 template<
     typename Base,
     typename E, 
     typename Comparator = Less
 >
-auto cfsLowerBound(Base b, Base e, const E &v, Comparator c = Comparator{}) {
+constexpr auto cfsLowerBound(
+    Base b, Base e, const E &v, Comparator c = Comparator{}
+) {
     return
         detail::cfsBound<detail::ONLY_LOWER_BOUND>(b, e, e - b, 0, v, c).first;
 }
@@ -145,20 +357,310 @@ template<
     typename E, 
     typename Comparator = Less
 >
-auto cfsHigherBound(Base b, Base e, const E &v, Comparator c = Comparator{}) {
+constexpr auto cfsHigherBound(
+    Base b, Base e, const E &v, Comparator c = Comparator{}
+) {
     return
         detail::cfsBound<detail::ONLY_UPPER_BOUND>(b, e, e - b, 0, v, c).first;
 }
 
+template<
+    typename Base,
+    typename E,
+    typename Comparator = Less
+>
+constexpr auto cfsLowerBound(
+    Branching, Base b, Base e, const E &v, Comparator c = Comparator{}
+) {
+    return cfsLowerBound(b, e, v, c);
+}
+
+template<
+    int PrefetchDistance,
+    typename Base,
+    typename E,
+    typename Comparator = Less
+>
+auto cfsLowerBound(
+    BranchFree<PrefetchDistance>,
+    Base b, Base e, const E &v, Comparator c = Comparator{}
+) {
+    return
+        detail::cfsBoundBranchFree<
+            PrefetchDistance, detail::ONLY_LOWER_BOUND
+        >(b, e, v, c);
+}
+
+template<
+    typename Base,
+    typename E,
+    typename Comparator = Less
+>
+constexpr auto cfsHigherBound(
+    Branching, Base b, Base e, const E &v, Comparator c = Comparator{}
+) {
+    return cfsHigherBound(b, e, v, c);
+}
+
+template<
+    int PrefetchDistance,
+    typename Base,
+    typename E,
+    typename Comparator = Less
+>
+auto cfsHigherBound(
+    BranchFree<PrefetchDistance>,
+    Base b, Base e, const E &v, Comparator c = Comparator{}
+) {
+    return
+        detail::cfsBoundBranchFree<
+            PrefetchDistance, detail::ONLY_UPPER_BOUND
+        >(b, e, v, c);
+}
+
 template<
     typename Base,
     typename E, 
     typename Comparator = Less
 >
-auto cfsEqualRange(Base b, Base e, const E &v, Comparator c = Comparator{}) {
+constexpr auto cfsEqualRange(
+    Base b, Base e, const E &v, Comparator c = Comparator{}
+) {
     return detail::cfsBound<detail::RANGE>(b, e, e - b, 0, v, c);
 }
 
+namespace detail {
+
+/// \brief Advances up to \c GroupSize keys through the tree in lockstep
+///
+/// All the levels but the last are complete, thus every key descends
+/// through them without checking for termination; the comparison selects
+/// the child without branching.  The loads of different keys are
+/// independent, hence the processor may overlap their cache misses.
+/// The results are written to \c out in the order of the keys
+template<
+    SearchPolicy Policy, int GroupSize,
+    typename Base, typename KeyIterator, typename Output, typename Comparator
+>
+Output cfsBoundBatch(
+    Base base, Base end,
+    KeyIterator keysBegin, KeyIterator keysEnd,
+    Output out,
+    Comparator c
+) {
+    static_assert(RANGE != Policy, "ranges are two batched bounds");
+    std::size_t size = end - base;
+    if(0 == size) {
+        for(; keysBegin != keysEnd; ++keysBegin) { *out++ = end; }
+        return out;
+    }
+    auto completeLevels = log2Floor(size);
+    KeyIterator keys[GroupSize];
+    std::size_t indices[GroupSize];
+    Base infima[GroupSize];
+    auto step = [&](int lane) {
+        auto ndx = indices[lane];
+        auto current = base + ndx;
+        auto &cmp = *current;
+        auto &e = *keys[lane];
+        bool goHigher =
+            ONLY_UPPER_BOUND == Policy ? not c(e, cmp) : c(cmp, e);
+        infima[lane] = goHigher ? infima[lane] : current;
+        indices[lane] = (ndx << 1) + 1 + goHigher;
+    };
+    while(keysBegin != keysEnd) {
+        auto count = 0;
+        do {
+            keys[count] = keysBegin++;
+            indices[count] = 0;
+            infima[count] = end;
+        } while(++count < GroupSize && keysBegin != keysEnd);
+        for(auto level = completeLevels; level--; ) {
+            for(auto lane = 0; lane < count; ++lane) { step(lane); }
+        }
+        for(auto lane = 0; lane < count; ++lane) {
+            if(indices[lane] < size) { step(lane); }
+            *out++ = infima[lane];
+        }
+    }
+    return out;
+}
+
+}
+
+/// \brief Lower bounds of all the keys in [keysBegin, keysEnd), written
+/// to \c out in the same order as the keys
+///
+/// The keys are searched in groups of \c GroupSize advancing in lockstep,
+/// so that the memory latency of the search of one key is hidden behind the
+/// others'
+template<
+    int GroupSize = 16,
+    typename Base,
+    typename KeyIterator,
+    typename Output,
+    typename Comparator = Less
+>
+Output cfsLowerBoundBatch(
+    Base b, Base e,
+    KeyIterator keysBegin, KeyIterator keysEnd,
+    Output out,
+    Comparator c = Comparator{}
+) {
+    return
+        detail::cfsBoundBatch<detail::ONLY_LOWER_BOUND, GroupSize>(
+            b, e, keysBegin, keysEnd, out, c
+        );
+}
+
+template<
+    int GroupSize = 16,
+    typename Base,
+    typename KeyIterator,
+    typename Output,
+    typename Comparator = Less
+>
+Output cfsHigherBoundBatch(
+    Base b, Base e,
+    KeyIterator keysBegin, KeyIterator keysEnd,
+    Output out,
+    Comparator c = Comparator{}
+) {
+    return
+        detail::cfsBoundBatch<detail::ONLY_UPPER_BOUND, GroupSize>(
+            b, e, keysBegin, keysEnd, out, c
+        );
+}
+
+/// \brief Writes to \c out the pair of the lower and higher bounds of each
+/// key, as \c cfsEqualRange would
+///
+/// As \c cfsEqualRange, the range is searched as the two bounds, batched
+template<
+    int GroupSize = 16,
+    typename Base,
+    typename KeyIterator,
+    typename Output,
+    typename Comparator = Less
+>
+Output cfsEqualRangeBatch(
+    Base b, Base e,
+    KeyIterator keysBegin, KeyIterator keysEnd,
+    Output out,
+    Comparator c = Comparator{}
+) {
+    while(keysBegin != keysEnd) {
+        Base lowers[GroupSize], highers[GroupSize];
+        auto groupEnd = keysBegin;
+        auto count = 0;
+        do { ++groupEnd; } while(++count < GroupSize && groupEnd != keysEnd);
+        cfsLowerBoundBatch<GroupSize>(b, e, keysBegin, groupEnd, lowers, c);
+        cfsHigherBoundBatch<GroupSize>(b, e, keysBegin, groupEnd, highers, c);
+        for(auto ndx = 0; ndx < count; ++ndx) {
+            *out++ = std::pair<Base, Base>{lowers[ndx], highers[ndx]};
+        }
+        keysBegin = groupEnd;
+    }
+    return out;
+}
+
+/// \brief The position in sorted order of the element at \c where,
+/// end - b for the end
+template<typename Base>
+constexpr std::size_t cfsRank(Base b, Base e, Base where) {
+    std::size_t size = e - b;
+    return e == where ? size : detail::cfsSortedIndex(size, where - b);
+}
+
+/// \brief The element at position \c sorted in sorted order, e if the
+/// position is past the last
+template<typename Base>
+constexpr Base cfsSelect(Base b, Base e, std::size_t sorted) {
+    std::size_t size = e - b;
+    return size <= sorted ? e : b + detail::cfsLayoutIndex(size, sorted);
+}
+
+/// \brief The count of elements not less than \c lo and less than \c hi
+///
+/// The difference of the ranks of the lower bounds, two descents without
+/// visiting the elements in between
+template<typename Base, typename E, typename Comparator = Less>
+std::size_t cfsCount(
+    Base b, Base e, const E &lo, const E &hi, Comparator c = Comparator{}
+) {
+    if(not c(lo, hi)) { return 0; }
+    return
+        cfsRank(b, e, cfsLowerBound(b, e, hi, c)) -
+        cfsRank(b, e, cfsLowerBound(b, e, lo, c));
+}
+
+/// \brief Iterates a CFS layout in sorted order
+///
+/// The iterator is the position in sorted order; the successor and
+/// predecessor are the next and previous positions, whose elements are
+/// found arithmetically, without extra memory nor walking the tree
+template<typename Base>
+class CfsInorderIterator {
+    Base base_;
+    std::size_t size_ = 0, rank_ = 0;
+
+public:
+    using traits = std::iterator_traits<Base>;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = typename traits::value_type;
+    using difference_type = typename traits::difference_type;
+    using pointer = typename traits::pointer;
+    using reference = typename traits::reference;
+
+    CfsInorderIterator() = default;
+    CfsInorderIterator(Base base, std::size_t size, std::size_t rank):
+        base_{base}, size_{size}, rank_{rank}
+    {}
+
+    /// \brief The iterator into the layout
+    Base layout() const { return cfsSelect(base_, base_ + size_, rank_); }
+    std::size_t rank() const noexcept { return rank_; }
+
+    reference operator*() const { return *layout(); }
+    auto operator->() const { return &**this; }
+
+    CfsInorderIterator &operator++() noexcept { ++rank_; return *this; }
+    CfsInorderIterator &operator--() noexcept { --rank_; return *this; }
+    CfsInorderIterator operator++(int) noexcept {
+        auto rv = *this;
+        ++rank_;
+        return rv;
+    }
+    CfsInorderIterator operator--(int) noexcept {
+        auto rv = *this;
+        --rank_;
+        return rv;
+    }
+
+    bool operator==(const CfsInorderIterator &other) const noexcept {
+        return rank_ == other.rank_;
+    }
+    bool operator!=(const CfsInorderIterator &other) const noexcept {
+        return rank_ != other.rank_;
+    }
+};
+
+/// \brief The in-order iterator to the element at \c where in the layout
+template<typename Base>
+auto cfsInorder(Base b, Base e, Base where) {
+    return CfsInorderIterator<Base>(b, e - b, cfsRank(b, e, where));
+}
+
+template<typename Base>
+auto cfsInorderBegin(Base b, Base e) {
+    return CfsInorderIterator<Base>(b, e - b, 0);
+}
+
+template<typename Base>
+auto cfsInorderEnd(Base b, Base e) {
+    return CfsInorderIterator<Base>(b, e - b, e - b);
+}
+
 struct ValidResult {
     bool worked_;
     long failureLocation;
@@ -181,7 +683,7 @@ auto validHeap(
         auto &element = *(base + current);
         auto lowerSubtree = higherSubtree - 1;
         if(c(element, *(base + lowerSubtree))) { return {false, lowerSubtree}; }
-        auto recursionResult = validHeap(base, lowerSubtree, max);
+        auto recursionResult = validHeap(base, lowerSubtree, max, c);
         if(!recursionResult) { return recursionResult; }
         if(c(*(base + higherSubtree), element)) {
             return {false, higherSubtree};
@@ -0,0 +1,128 @@
+#ifndef ZOO_CFS_AGGREGATE
+#define ZOO_CFS_AGGREGATE
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+// because of std::plus needed by the sums
+#include <functional>
+// because of std::numeric_limits needed by the identity of the minimum
+#include <limits>
+#endif
+
+namespace zoo {
+
+/// \brief The combination of the minima of subtrees, for \c cfsMin
+struct Minimum {
+    template<typename V>
+    const V &operator()(const V &l, const V &r) const {
+        return r < l ? r : l;
+    }
+};
+
+/// \brief Writes to \c aggregates, parallel to the CFS array of the values
+/// [values, valuesEnd), the combination of the values of each subtree
+///
+/// The values are in the CFS order of their keys, as the values of
+/// \c CfsMap; \c combine is associative and commutative
+template<typename ValueIterator, typename Aggregates, typename Combine>
+void cfsSubtreeAggregates(
+    ValueIterator values, ValueIterator valuesEnd,
+    Aggregates aggregates, Combine combine
+) {
+    std::size_t size = valuesEnd - values;
+    for(auto ndx = size; ndx--; ) {
+        auto rv = values[ndx];
+        auto lower = 2*ndx + 1;
+        if(lower < size) { rv = combine(rv, aggregates[lower]); }
+        if(lower + 1 < size) { rv = combine(rv, aggregates[lower + 1]); }
+        aggregates[ndx] = rv;
+    }
+}
+
+/// \brief The combination of the values of the keys not less than \c lo
+/// and less than \c hi, \c identity if there are none
+///
+/// The descent splits at the first key in the range; from there, the
+/// suffix of the lower subtree and the prefix of the higher are each one
+/// path, combining the aggregates of the whole subtrees hanging from them.
+/// \pre \c aggregates were computed by \c cfsSubtreeAggregates with
+/// \c combine
+template<
+    typename Base, typename ValueIterator, typename Aggregates,
+    typename E, typename V, typename Combine,
+    typename Comparator = Less
+>
+V cfsAggregate(
+    Base b, Base e, ValueIterator values, Aggregates aggregates,
+    const E &lo, const E &hi, V identity, Combine combine,
+    Comparator c = Comparator{}
+) {
+    std::size_t size = e - b, split = 0;
+    while(split < size) {
+        auto &key = b[split];
+        if(c(key, lo)) { split = 2*split + 2; }
+        else if(not c(key, hi)) { split = 2*split + 1; }
+        else { break; }
+    }
+    if(size <= split) { return identity; }
+    V rv = combine(identity, values[split]);
+    // the keys of the lower subtree are less than hi
+    for(auto ndx = 2*split + 1; ndx < size; ) {
+        if(c(b[ndx], lo)) {
+            ndx = 2*ndx + 2;
+            continue;
+        }
+        rv = combine(rv, values[ndx]);
+        if(2*ndx + 2 < size) { rv = combine(rv, aggregates[2*ndx + 2]); }
+        ndx = 2*ndx + 1;
+    }
+    // the keys of the higher subtree are not less than lo
+    for(auto ndx = 2*split + 2; ndx < size; ) {
+        if(not c(b[ndx], hi)) {
+            ndx = 2*ndx + 1;
+            continue;
+        }
+        rv = combine(rv, values[ndx]);
+        if(2*ndx + 1 < size) { rv = combine(rv, aggregates[2*ndx + 1]); }
+        ndx = 2*ndx + 2;
+    }
+    return rv;
+}
+
+/// \brief The sum of the values of the keys in [lo, hi)
+/// \pre \c sums computed by \c cfsSubtreeAggregates with \c std::plus
+template<
+    typename Base, typename ValueIterator, typename Aggregates,
+    typename E, typename Comparator = Less
+>
+auto cfsSum(
+    Base b, Base e, ValueIterator values, Aggregates sums,
+    const E &lo, const E &hi, Comparator c = Comparator{}
+) {
+    using V = typename std::iterator_traits<ValueIterator>::value_type;
+    return cfsAggregate(b, e, values, sums, lo, hi, V{}, std::plus<V>{}, c);
+}
+
+/// \brief The least of the values of the keys in [lo, hi), the maximum of
+/// the type of the values if there are none
+/// \pre \c minima computed by \c cfsSubtreeAggregates with \c Minimum
+template<
+    typename Base, typename ValueIterator, typename Aggregates,
+    typename E, typename Comparator = Less
+>
+auto cfsMin(
+    Base b, Base e, ValueIterator values, Aggregates minima,
+    const E &lo, const E &hi, Comparator c = Comparator{}
+) {
+    using V = typename std::iterator_traits<ValueIterator>::value_type;
+    return
+        cfsAggregate(
+            b, e, values, minima, lo, hi, std::numeric_limits<V>::max(),
+            Minimum{}, c
+        );
+}
+
+}
+
+#endif
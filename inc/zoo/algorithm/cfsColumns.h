@@ -0,0 +1,101 @@
+#ifndef ZOO_CFS_COLUMNS
+#define ZOO_CFS_COLUMNS
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#endif
+
+namespace zoo {
+
+/// \brief Writes each of the sorted columns in CFS order
+///
+/// The rows are sorted lexicographically; since the CFS permutation
+/// depends only on the count, the columns remain parallel.
+/// \pre each output is random access or an output iterator for \c size
+/// elements
+template<typename... Outputs, typename... Inputs>
+void transformColumnsToCFS(
+    std::tuple<Outputs...> outputs,
+    std::tuple<Inputs...> bases,
+    std::size_t size
+) {
+    static_assert(sizeof...(Outputs) == sizeof...(Inputs));
+    std::apply(
+        [&](auto... output) {
+            std::apply(
+                [&](auto... base) {
+                    (transformToCFS(output, base, base + size), ...);
+                },
+                bases
+            );
+        },
+        outputs
+    );
+}
+
+namespace detail {
+
+/// \brief Whether the row \c ndx is less than the keys, comparing the
+/// cells of the later columns only when the earlier are equivalent
+template<
+    std::size_t Column, typename Columns, typename Keys, typename Comparator
+>
+constexpr bool cfsRowLess(
+    const Columns &columns, std::size_t ndx, const Keys &keys, Comparator c
+) {
+    auto &cell = *(std::get<Column>(columns) + ndx);
+    auto &key = std::get<Column>(keys);
+    if constexpr(Column + 1 == std::tuple_size_v<Keys>) {
+        return c(cell, key);
+    } else {
+        if(c(cell, key)) { return true; }
+        if(c(key, cell)) { return false; }
+        return cfsRowLess<Column + 1>(columns, ndx, keys, c);
+    }
+}
+
+}
+
+/// \brief The index of the first row of the CFS columns not less than
+/// the keys, lexicographically
+///
+/// The columns are in CFS order, as by \c transformColumnsToCFS; there may
+/// be fewer keys than columns, then the rows are compared only on the
+/// leading columns.  Each node of the descent loads the cell of the first
+/// column, and the next columns only on ties.
+/// \returns \c size if all the rows are less than the keys
+template<
+    typename... Bases,
+    typename... Keys,
+    typename Comparator = Less
+>
+constexpr std::size_t cfsLowerBound(
+    const std::tuple<Bases...> &columns,
+    std::size_t size,
+    const std::tuple<Keys...> &keys,
+    Comparator c = Comparator{}
+) {
+    static_assert(
+        0 < sizeof...(Keys) && sizeof...(Keys) <= sizeof...(Bases),
+        "the keys are a prefix of the columns"
+    );
+    auto rv = size;
+    std::size_t ndx = 0;
+    while(ndx < size) {
+        if(detail::cfsRowLess<0>(columns, ndx, keys, c)) {
+            ndx = (ndx << 1) + 2;
+        } else {
+            rv = ndx;
+            ndx = (ndx << 1) + 1;
+        }
+    }
+    return rv;
+}
+
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef ZOO_CFS_PARALLEL_CACHE_FRIENDLY_SEARCH
+#define ZOO_CFS_PARALLEL_CACHE_FRIENDLY_SEARCH
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <thread>
+#include <vector>
+#endif
+
+namespace zoo {
+
+namespace detail {
+
+template<typename Output, typename Input>
+void transformToCFSSlice(
+    Output output, Input base, std::size_t size,
+    std::size_t from, std::size_t to
+) {
+    for(auto ndx = from; ndx < to; ++ndx) {
+        *(output + ndx) = *(base + cfsSortedIndex(size, ndx));
+    }
+}
+
+}
+
+/// \brief Writes the sorted range [base, end) in CFS order, as
+/// \c transformToCFS, from \c threadCount threads
+///
+/// Each thread writes a contiguous slice of the output, computing for each
+/// index its position in the input, the writes are sequential and the
+/// reads of the lower levels, which are most of the elements, are strided.
+/// \param threadCount 0 means as many as the hardware supports
+/// \pre the output is random access with end - base elements
+/// \note copying the elements must not throw; if starting a thread
+/// throws, the threads started are joined and the exception propagates,
+/// with the output partially written
+template<typename Output, typename Input>
+void transformToCFSParallel(
+    Output output, Input base, Input end, unsigned threadCount = 0
+) {
+    std::size_t size = end - base;
+    if(0 == size) { return; }
+    if(0 == threadCount) {
+        threadCount = std::thread::hardware_concurrency();
+        if(0 == threadCount) { threadCount = 1; }
+    }
+    if(size < threadCount) { threadCount = size; }
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    auto sliceEnd = [&](unsigned slice) {
+        return size * slice / threadCount;
+    };
+    try {
+        for(auto slice = 1u; slice < threadCount; ++slice) {
+            threads.emplace_back(
+                detail::transformToCFSSlice<Output, Input>,
+                output, base, size, sliceEnd(slice), sliceEnd(slice + 1)
+            );
+        }
+    } catch(...) {
+        // destroying joinable threads would terminate
+        for(auto &thread: threads) { thread.join(); }
+        throw;
+    }
+    detail::transformToCFSSlice(output, base, size, 0, sliceEnd(1));
+    for(auto &thread: threads) { thread.join(); }
+}
+
+}
+
+#endif
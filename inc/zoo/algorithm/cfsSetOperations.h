@@ -0,0 +1,385 @@
+#ifndef ZOO_CFS_SET_OPERATIONS
+#define ZOO_CFS_SET_OPERATIONS
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+// because of std::copy needed to write the output
+#include <algorithm>
+// because of std::vector needed by the chunks of the merges
+#include <vector>
+#endif
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace zoo {
+
+namespace detail {
+
+/// \brief Whether searching \c small keys in \c large costs less than
+/// streaming \c large
+constexpr bool cfsLopsided(std::size_t small, std::size_t large) {
+    return small < large && small * (log2Floor(large) + 1) < large;
+}
+
+/// \brief The ranks of the lower and higher bounds of \c v
+template<typename Base, typename E, typename Comparator>
+auto cfsEquivalentRanks(Base b, Base e, const E &v, Comparator c) {
+    return std::pair<std::size_t, std::size_t>{
+        cfsRank(b, e, cfsLowerBound(b, e, v, c)),
+        cfsRank(b, e, cfsHigherBound(b, e, v, c))
+    };
+}
+
+/// \brief Copies the elements of ranks [from, to) in sorted order
+template<typename Base, typename Output>
+Output cfsCopyRanks(
+    Base b, Base e, std::size_t from, std::size_t to, Output out
+) {
+    std::size_t size = e - b;
+    return
+        std::copy(
+            CfsInorderIterator<Base>(b, size, from),
+            CfsInorderIterator<Base>(b, size, to),
+            out
+        );
+}
+
+/// \brief The end of the run of elements equivalent to the one at \c i
+template<typename I, typename Comparator>
+I cfsRunEnd(I i, I end, Comparator c) {
+    auto rv = i;
+    while(end != ++rv && not c(*i, *rv)) {}
+    return rv;
+}
+
+/// \brief Visits the runs of equivalent elements in sorted order, with the
+/// in-order iterator to the first and the count of the run
+template<typename Base, typename Comparator, typename Callable>
+void cfsForEachRun(Base b, Base e, Comparator c, Callable &&callable) {
+    for(
+        auto i = cfsInorderBegin(b, e), end = cfsInorderEnd(b, e);
+        end != i;
+    ) {
+        auto runEnd = cfsRunEnd(i, end, c);
+        callable(i, runEnd.rank() - i.rank());
+        i = runEnd;
+    }
+}
+
+enum SetOperation { INTERSECTION, UNION, DIFFERENCE };
+
+/// \brief Merges [l, lEnd) and [r, rEnd) until either is consumed, \c l
+/// and \c r are left where the merge stopped
+template<
+    SetOperation Operation,
+    typename L, typename R, typename Output, typename Comparator
+>
+Output mergeSorted(L &l, L lEnd, R &r, R rEnd, Output out, Comparator c) {
+    while(lEnd != l && rEnd != r) {
+        if(c(*l, *r)) {
+            if constexpr(INTERSECTION != Operation) { *out++ = *l; }
+            ++l;
+        } else if(c(*r, *l)) {
+            if constexpr(UNION == Operation) { *out++ = *r; }
+            ++r;
+        } else {
+            if constexpr(DIFFERENCE != Operation) { *out++ = *l; }
+            ++l;
+            ++r;
+        }
+    }
+    return out;
+}
+
+/// \brief Applies \c merge to chunks of the sorted orders of both CFS
+/// arrays, refilling the chunk that it consumes
+///
+/// Copying the chunks out of the layouts spares the merge the arithmetic
+/// of the in-order iterators on every comparison.  Any element of either
+/// chunk is consumed once, hence the result is that of merging the whole
+/// sorted orders
+template<
+    SetOperation Operation,
+    typename Base1, typename Base2, typename Output, typename Merge
+>
+Output cfsMergeInChunks(
+    Base1 b1, Base1 e1, Base2 b2, Base2 e2, Output out, Merge &&merge
+) {
+    constexpr std::size_t Chunk = 256;
+    std::vector<typename std::iterator_traits<Base1>::value_type> left;
+    std::vector<typename std::iterator_traits<Base2>::value_type> right;
+    left.reserve(Chunk);
+    right.reserve(Chunk);
+    auto l = cfsInorderBegin(b1, e1), lEnd = cfsInorderEnd(b1, e1);
+    auto r = cfsInorderBegin(b2, e2), rEnd = cfsInorderEnd(b2, e2);
+    for(;;) {
+        for(; left.size() < Chunk && lEnd != l; ++l) { left.push_back(*l); }
+        for(; right.size() < Chunk && rEnd != r; ++r) { right.push_back(*r); }
+        if(left.empty() || right.empty()) { break; }
+        const auto *lData = left.data();
+        const auto *rData = right.data();
+        auto lConsumed = lData;
+        auto rConsumed = rData;
+        out =
+            merge(
+                lConsumed, lData + left.size(), rConsumed, rData + right.size(),
+                out
+            );
+        left.erase(left.begin(), left.begin() + (lConsumed - lData));
+        right.erase(right.begin(), right.begin() + (rConsumed - rData));
+    }
+    // at most one side remains
+    if constexpr(INTERSECTION != Operation) {
+        out = std::copy(left.begin(), left.end(), out);
+        out = std::copy(l, lEnd, out);
+    }
+    if constexpr(UNION == Operation) {
+        out = std::copy(right.begin(), right.end(), out);
+        out = std::copy(r, rEnd, out);
+    }
+    return out;
+}
+
+template<
+    SetOperation Operation,
+    typename Base1, typename Base2, typename Output, typename Comparator
+>
+Output cfsMerge(
+    Base1 b1, Base1 e1, Base2 b2, Base2 e2, Output out, Comparator c
+) {
+    return
+        cfsMergeInChunks<Operation>(
+            b1, e1, b2, e2, out,
+            [c](auto &l, auto lEnd, auto &r, auto rEnd, Output o) {
+                return mergeSorted<Operation>(l, lEnd, r, rEnd, o, c);
+            }
+        );
+}
+
+}
+
+/// \brief Writes in sorted order the elements of the first CFS array that
+/// have equivalents in the second, as \c std::set_intersection
+///
+/// The arrays are merged in sorted order, unless one is so much smaller
+/// that searching its keys in the other is cheaper.  As in the other set
+/// operations, \c transformToCFS lays out the sorted result if needed
+template<
+    typename Base1, typename Base2, typename Output,
+    typename Comparator = Less
+>
+Output cfsIntersect(
+    Base1 b1, Base1 e1, Base2 b2, Base2 e2,
+    Output out, Comparator c = Comparator{}
+) {
+    std::size_t size1 = e1 - b1, size2 = e2 - b2;
+    if(detail::cfsLopsided(size1, size2)) {
+        detail::cfsForEachRun(b1, e1, c, [&](auto run, std::size_t count) {
+            auto ranks = detail::cfsEquivalentRanks(b2, e2, *run, c);
+            auto inSecond = ranks.second - ranks.first;
+            auto from = run.rank();
+            out = detail::cfsCopyRanks(
+                b1, e1, from, from + std::min(count, inSecond), out
+            );
+        });
+        return out;
+    }
+    if(detail::cfsLopsided(size2, size1)) {
+        detail::cfsForEachRun(b2, e2, c, [&](auto run, std::size_t count) {
+            auto ranks = detail::cfsEquivalentRanks(b1, e1, *run, c);
+            auto inFirst = ranks.second - ranks.first;
+            out = detail::cfsCopyRanks(
+                b1, e1, ranks.first, ranks.first + std::min(count, inFirst),
+                out
+            );
+        });
+        return out;
+    }
+    return detail::cfsMerge<detail::INTERSECTION>(b1, e1, b2, e2, out, c);
+}
+
+/// \brief Writes in sorted order the elements of both CFS arrays, as
+/// \c std::set_union
+template<
+    typename Base1, typename Base2, typename Output,
+    typename Comparator = Less
+>
+Output cfsUnion(
+    Base1 b1, Base1 e1, Base2 b2, Base2 e2,
+    Output out, Comparator c = Comparator{}
+) {
+    std::size_t size1 = e1 - b1, size2 = e2 - b2;
+    if(detail::cfsLopsided(size1, size2)) {
+        // the elements of the second between the runs of the first
+        std::size_t copied = 0;
+        detail::cfsForEachRun(b1, e1, c, [&](auto run, std::size_t count) {
+            auto ranks = detail::cfsEquivalentRanks(b2, e2, *run, c);
+            out = detail::cfsCopyRanks(b2, e2, copied, ranks.first, out);
+            out = detail::cfsCopyRanks(
+                b1, e1, run.rank(), run.rank() + count, out
+            );
+            auto inSecond = ranks.second - ranks.first;
+            if(count < inSecond) {
+                out = detail::cfsCopyRanks(
+                    b2, e2, ranks.first + count, ranks.second, out
+                );
+            }
+            copied = ranks.second;
+        });
+        return detail::cfsCopyRanks(b2, e2, copied, size2, out);
+    }
+    if(detail::cfsLopsided(size2, size1)) {
+        // the runs of the second past the equivalents in the first
+        std::size_t copied = 0;
+        detail::cfsForEachRun(b2, e2, c, [&](auto run, std::size_t count) {
+            auto ranks = detail::cfsEquivalentRanks(b1, e1, *run, c);
+            out = detail::cfsCopyRanks(b1, e1, copied, ranks.second, out);
+            copied = ranks.second;
+            auto inFirst = ranks.second - ranks.first;
+            auto last = run.rank() + count;
+            if(inFirst < count) {
+                out = detail::cfsCopyRanks(
+                    b2, e2, last - (count - inFirst), last, out
+                );
+            }
+        });
+        return detail::cfsCopyRanks(b1, e1, copied, size1, out);
+    }
+    return detail::cfsMerge<detail::UNION>(b1, e1, b2, e2, out, c);
+}
+
+/// \brief Writes in sorted order the elements of the first CFS array not
+/// in the second, as \c std::set_difference
+template<
+    typename Base1, typename Base2, typename Output,
+    typename Comparator = Less
+>
+Output cfsDifference(
+    Base1 b1, Base1 e1, Base2 b2, Base2 e2,
+    Output out, Comparator c = Comparator{}
+) {
+    std::size_t size1 = e1 - b1, size2 = e2 - b2;
+    if(detail::cfsLopsided(size1, size2)) {
+        detail::cfsForEachRun(b1, e1, c, [&](auto run, std::size_t count) {
+            auto ranks = detail::cfsEquivalentRanks(b2, e2, *run, c);
+            auto inSecond = ranks.second - ranks.first;
+            if(inSecond < count) {
+                auto last = run.rank() + count;
+                out = detail::cfsCopyRanks(
+                    b1, e1, last - (count - inSecond), last, out
+                );
+            }
+        });
+        return out;
+    }
+    if(detail::cfsLopsided(size2, size1)) {
+        // the elements of the first between the runs of the second
+        std::size_t copied = 0;
+        detail::cfsForEachRun(b2, e2, c, [&](auto run, std::size_t count) {
+            auto ranks = detail::cfsEquivalentRanks(b1, e1, *run, c);
+            out = detail::cfsCopyRanks(b1, e1, copied, ranks.first, out);
+            auto inFirst = ranks.second - ranks.first;
+            copied = ranks.first + std::min(count, inFirst);
+        });
+        return detail::cfsCopyRanks(b1, e1, copied, size1, out);
+    }
+    return detail::cfsMerge<detail::DIFFERENCE>(b1, e1, b2, e2, out, c);
+}
+
+/// \brief Tag to intersect CFS arrays of \c int with a SIMD merge kernel
+///
+/// \pre the keys of each array are strictly increasing in sorted order,
+/// without repetitions, under \c Less
+struct SimdMerge {};
+
+namespace detail {
+
+#if defined(__SSE2__)
+/// \brief Intersects the strictly increasing [l, lEnd) and [r, rEnd) as
+/// \c mergeSorted
+///
+/// Blocks of four of each side are compared all against all, the block
+/// with the lesser maximum is consumed; a block compared again with the
+/// next block of the other side can not match twice since the keys are
+/// unique
+template<typename Output>
+Output intersectInts(
+    const int *&l, const int *lEnd, const int *&r, const int *rEnd,
+    Output out
+) {
+    while(4 <= lEnd - l && 4 <= rEnd - r) {
+        auto lefts = _mm_loadu_si128(reinterpret_cast<const __m128i *>(l));
+        auto rights = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r));
+        auto equal =
+            _mm_or_si128(
+                _mm_or_si128(
+                    _mm_cmpeq_epi32(lefts, rights),
+                    _mm_cmpeq_epi32(
+                        lefts, _mm_shuffle_epi32(rights, _MM_SHUFFLE(0,3,2,1))
+                    )
+                ),
+                _mm_or_si128(
+                    _mm_cmpeq_epi32(
+                        lefts, _mm_shuffle_epi32(rights, _MM_SHUFFLE(1,0,3,2))
+                    ),
+                    _mm_cmpeq_epi32(
+                        lefts, _mm_shuffle_epi32(rights, _MM_SHUFFLE(2,1,0,3))
+                    )
+                )
+            );
+        for(
+            auto mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+            mask;
+            mask &= mask - 1
+        ) {
+            *out++ = l[__builtin_ctz(mask)];
+        }
+        auto leftMaximum = l[3], rightMaximum = r[3];
+        if(leftMaximum <= rightMaximum) { l += 4; }
+        if(rightMaximum <= leftMaximum) { r += 4; }
+    }
+    return mergeSorted<INTERSECTION>(l, lEnd, r, rEnd, out, Less{});
+}
+#endif
+
+}
+
+/// \brief \c cfsIntersect of CFS arrays of \c int, the chunks of the
+/// sorted orders are merged by a SIMD kernel
+///
+/// Without SSE2, or when searching is cheaper than merging, the same as
+/// the untagged \c cfsIntersect
+template<typename Base1, typename Base2, typename Output>
+Output cfsIntersect(
+    SimdMerge, Base1 b1, Base1 e1, Base2 b2, Base2 e2, Output out
+) {
+    using T1 = typename std::iterator_traits<Base1>::value_type;
+    using T2 = typename std::iterator_traits<Base2>::value_type;
+    static_assert(
+        std::is_same_v<int, T1> && std::is_same_v<int, T2>,
+        "the SIMD kernel is for int keys"
+    );
+    #if defined(__SSE2__)
+    std::size_t size1 = e1 - b1, size2 = e2 - b2;
+    if(
+        not detail::cfsLopsided(size1, size2) &&
+        not detail::cfsLopsided(size2, size1)
+    ) {
+        return
+            detail::cfsMergeInChunks<detail::INTERSECTION>(
+                b1, e1, b2, e2, out,
+                [](auto &l, auto lEnd, auto &r, auto rEnd, Output o) {
+                    return detail::intersectInts(l, lEnd, r, rEnd, o);
+                }
+            );
+    }
+    #endif
+    return cfsIntersect(b1, e1, b2, e2, out);
+}
+
+}
+
+#endif
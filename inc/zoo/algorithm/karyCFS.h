@@ -0,0 +1,148 @@
+#ifndef ZOO_KARY_CFS_CACHE_FRIENDLY_SEARCH
+#define ZOO_KARY_CFS_CACHE_FRIENDLY_SEARCH
+
+#include <zoo/algorithm/cfs.h>
+
+#ifndef SIMPLIFY_INCLUDES
+// because of std::iterator_traits needed for the types of elements
+#include <iterator>
+#endif
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace zoo {
+
+/// \brief The layout of the k-ary tree: every node holds \c KeysPerNode
+/// sorted keys and has KeysPerNode + 1 children.
+///
+/// The default of the keys per node is as many as fit in a cache line
+template<typename T, int KeysPerNode = 0>
+constexpr int KaryKeysPerNode =
+    0 < KeysPerNode ? KeysPerNode :
+        sizeof(T) < 64 ? int(64 / sizeof(T)) : 1;
+
+/// \brief Number of elements of the k-ary layout for \c size keys,
+/// the last node is padded
+template<int KeysPerNode>
+constexpr std::size_t karyCFSSize(std::size_t size) {
+    return (size + KeysPerNode - 1) / KeysPerNode * KeysPerNode;
+}
+
+namespace detail {
+
+template<int B, typename Output, typename Input, typename T>
+void karyFill(
+    Output output, std::size_t nodes, std::size_t node,
+    Input &from, Input end, const T &padding
+) {
+    if(nodes <= node) { return; }
+    auto firstChild = node * (B + 1) + 1;
+    auto keys = output + node * B;
+    for(auto ndx = 0; ndx < B; ++ndx) {
+        karyFill<B>(output, nodes, firstChild + ndx, from, end, padding);
+        *(keys + ndx) = from != end ? *from++ : padding;
+    }
+    karyFill<B>(output, nodes, firstChild + B, from, end, padding);
+}
+
+/// \brief How many keys in the node are less than \c e
+template<int B, typename Base, typename E, typename Comparator>
+int karyRank(Base node, const E &e, Comparator c) {
+    using T = std::decay_t<decltype(*node)>;
+    #if defined(__SSE2__)
+    if constexpr(
+        std::is_same_v<Less, Comparator> && std::is_same_v<int, T> &&
+        std::is_same_v<int, E> && 0 == B % 4
+    ) {
+        const int *keys = &*node;
+        int rv = 0;
+        #if defined(__AVX2__)
+        if constexpr(0 == B % 8) {
+            auto broadcast = _mm256_set1_epi32(e);
+            for(auto ndx = 0; ndx < B; ndx += 8) {
+                auto loaded =
+                    _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(keys + ndx)
+                    );
+                auto less = _mm256_cmpgt_epi32(broadcast, loaded);
+                rv += __builtin_popcount(
+                    _mm256_movemask_ps(_mm256_castsi256_ps(less))
+                );
+            }
+            return rv;
+        }
+        #endif
+        auto broadcast = _mm_set1_epi32(e);
+        for(auto ndx = 0; ndx < B; ndx += 4) {
+            auto loaded =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + ndx));
+            auto less = _mm_cmpgt_epi32(broadcast, loaded);
+            rv += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(less)));
+        }
+        return rv;
+    }
+    #endif
+    // the keys in the node are sorted, counting does not depend on where the
+    // first not less is, which allows vectorization
+    auto rv = 0;
+    for(auto ndx = 0; ndx < B; ++ndx) {
+        rv += c(*(node + ndx), e);
+    }
+    return rv;
+}
+
+}
+
+/// \brief Writes the sorted range [base, end) as a k-ary search tree of
+/// nodes of \c KeysPerNode keys in breadth first order (S-tree)
+///
+/// The children of node k are the nodes k*(B + 1) + 1 to k*(B + 1) + B + 1,
+/// the keys of the tree in order are the input; the last node is padded
+/// with copies of the maximum, which come after all of the input.
+/// \tparam KeysPerNode 0 means as many as fit in a cache line
+/// \pre the output is random access, with karyCFSSize<B>(end - base)
+/// elements
+template<
+    int KeysPerNode = 0, typename Output, typename Input
+>
+void transformToKaryCFS(Output output, Input base, Input end) {
+    using T = typename std::iterator_traits<Input>::value_type;
+    constexpr auto B = KaryKeysPerNode<T, KeysPerNode>;
+    std::size_t size = end - base;
+    if(0 == size) { return; }
+    const T padding = *(end - 1);
+    auto nodes = karyCFSSize<B>(size) / B;
+    detail::karyFill<B>(output, nodes, 0, base, end, padding);
+}
+
+/// \brief The first element of the k-ary tree in [b, e) not less than \c v
+///
+/// Each node is ranked with SIMD comparisons for \c int and the default
+/// comparator, which requires the nodes to be contiguous; if the nodes are
+/// also aligned to the cache line, each level is one cache miss.
+/// \returns \c e if all elements are less than \c v
+template<
+    int KeysPerNode = 0,
+    typename Base,
+    typename E,
+    typename Comparator = Less
+>
+Base karyLowerBound(Base b, Base e, const E &v, Comparator c = Comparator{}) {
+    using T = std::decay_t<decltype(*b)>;
+    constexpr auto B = KaryKeysPerNode<T, KeysPerNode>;
+    std::size_t nodes = (e - b) / B, node = 0;
+    auto rv = e;
+    while(node < nodes) {
+        auto keys = b + node * B;
+        auto rank = detail::karyRank<B>(keys, v, c);
+        if(rank < B) { rv = keys + rank; }
+        node = node * (B + 1) + rank + 1;
+    }
+    return rv;
+}
+
+}
+
+#endif
@@ -5,7 +5,7 @@ namespace zoo {
 
 struct Less {
     template<typename T1, typename T2>
-    bool operator()(const T1 &l, const T2 &r) {
+    constexpr bool operator()(const T1 &l, const T2 &r) const {
         return l < r;
     }
 };
@@ -0,0 +1,159 @@
+#ifndef ZOO_VAN_EMDE_BOAS_LAYOUT
+#define ZOO_VAN_EMDE_BOAS_LAYOUT
+
+#include <zoo/algorithm/less.h>
+
+#ifndef SIMPLIFY_INCLUDES
+#include <array>
+#include <cstddef>
+// because of std::iterator_traits needed for the types of elements
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#endif
+
+namespace zoo {
+
+/// \brief Number of elements of the van Emde Boas layout for \c size keys:
+/// the smallest perfect tree that holds them, of 2^h - 1 nodes
+constexpr std::size_t vebSize(std::size_t size) {
+    std::size_t rv = 0;
+    while(rv < size) { rv = 2*rv + 1; }
+    return rv;
+}
+
+namespace detail {
+
+constexpr int VEBMaximumHeight = 48;
+
+/// \brief The nodes at a depth that are roots of bottom trees of the
+/// recursive split: the bottom trees follow the top tree whose root is at
+/// \c topRootDepth, the sizes are 2^k - 1, also the mask of the child
+/// index of a node among the bottom trees of its top tree
+struct VEBDepth {
+    std::size_t topSize = 0, bottomSize = 0;
+    int topRootDepth = 0;
+};
+
+using VEBTables = std::array<VEBDepth, VEBMaximumHeight>;
+
+/// \brief Splits the tree of \c height rooted at \c rootDepth into a top
+/// tree of half the height, rounded down, and the bottom trees of the rest
+constexpr void vebSplit(VEBTables &tables, int rootDepth, int height) {
+    if(height < 2) { return; }
+    auto topHeight = height / 2, bottomHeight = height - topHeight;
+    auto &bottomRoots = tables[rootDepth + topHeight];
+    bottomRoots.topSize = (std::size_t(1) << topHeight) - 1;
+    bottomRoots.bottomSize = (std::size_t(1) << bottomHeight) - 1;
+    bottomRoots.topRootDepth = rootDepth;
+    vebSplit(tables, rootDepth, topHeight);
+    vebSplit(tables, rootDepth + topHeight, bottomHeight);
+}
+
+constexpr std::array<VEBTables, VEBMaximumHeight + 1> makeVEBTables() {
+    std::array<VEBTables, VEBMaximumHeight + 1> rv{};
+    for(auto height = 0; height <= VEBMaximumHeight; ++height) {
+        vebSplit(rv[height], 0, height);
+    }
+    return rv;
+}
+
+/// \brief The tables of the perfect trees of each height
+inline constexpr auto VEBTablesByHeight = makeVEBTables();
+
+constexpr int vebHeight(std::size_t size) {
+    auto rv = 0;
+    while(size) {
+        size >>= 1;
+        ++rv;
+    }
+    return rv;
+}
+
+/// \brief Position in the layout of the node \c bfs, the 1-based breadth
+/// first index, at \c depth
+constexpr std::size_t vebPosition(
+    const VEBTables &tables, std::size_t bfs, int depth
+) {
+    if(0 == depth) { return 0; }
+    auto &d = tables[depth];
+    auto topRoot = bfs >> (depth - d.topRootDepth);
+    return
+        vebPosition(tables, topRoot, d.topRootDepth) + d.topSize +
+            (bfs & d.topSize) * d.bottomSize;
+}
+
+}
+
+/// \brief Writes the sorted range [base, end) as a binary search tree in
+/// van Emde Boas order
+///
+/// The tree is split at half its height into a top tree and the bottom
+/// trees hanging from it, laid out one after the other, each recursively;
+/// subtrees of every height are contiguous, so the search incurs
+/// O(log_B(n)) cache misses for any cache line size B, without knowing it.
+/// The tree is perfect, the nodes after the input are copies of the
+/// maximum.
+/// \pre the output is random access, with vebSize(end - base) elements
+/// \throws std::length_error if the tree would have more than 2^48 - 1
+/// nodes, the height of \c detail::VEBMaximumHeight of the position tables
+template<typename Output, typename Input>
+void transformToVEB(Output output, Input base, Input end) {
+    using T = typename std::iterator_traits<Input>::value_type;
+    std::size_t size = end - base;
+    if(0 == size) { return; }
+    const T padding = *(end - 1);
+    auto nodes = vebSize(size);
+    auto height = detail::vebHeight(nodes);
+    if(detail::VEBMaximumHeight < height) {
+        throw std::length_error("van Emde Boas tree too high");
+    }
+    auto &tables = detail::VEBTablesByHeight[height];
+    // in order the reads are sequential and the writes scattered
+    for(std::size_t inorder = 0; inorder < nodes; ++inorder) {
+        auto oneBased = inorder + 1;
+        auto trailingZeros = __builtin_ctzll(oneBased);
+        auto depth = height - 1 - trailingZeros;
+        auto bfs =
+            (std::size_t(1) << depth) + (oneBased >> (trailingZeros + 1));
+        *(output + detail::vebPosition(tables, bfs, depth)) =
+            inorder < size ? *base++ : padding;
+    }
+}
+
+/// \brief The first element of the van Emde Boas tree in [b, e) not less
+/// than \c v
+///
+/// The position of each node is computed from the position of the root of
+/// its top tree, remembered for each depth along the descent.
+/// \returns \c e if all elements are less than \c v
+/// \pre [b, e) is the output of \c transformToVEB: e - b is 2^h - 1, with
+/// h at most \c detail::VEBMaximumHeight; other sizes are not checked and
+/// lead to reads out of bounds
+template<typename Base, typename E, typename Comparator = Less>
+Base vebLowerBound(Base b, Base e, const E &v, Comparator c = Comparator{}) {
+    std::size_t nodes = e - b;
+    auto height = detail::vebHeight(nodes);
+    auto &tables = detail::VEBTablesByHeight[height];
+    std::size_t positions[detail::VEBMaximumHeight];
+    std::size_t bfs = 1, position = 0;
+    auto rv = e;
+    for(auto depth = 0; depth < height; ++depth) {
+        if(depth) {
+            auto &d = tables[depth];
+            position =
+                positions[d.topRootDepth] + d.topSize +
+                    (bfs & d.topSize) * d.bottomSize;
+        }
+        positions[depth] = position;
+        auto node = b + position;
+        auto less = c(*node, v);
+        if(!less) { rv = node; }
+        bfs = 2*bfs + less;
+    }
+    return rv;
+}
+
+}
+
+#endif
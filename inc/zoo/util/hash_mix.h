@@ -0,0 +1,24 @@
+#ifndef ZOO_HASH_MIX
+#define ZOO_HASH_MIX
+
+#ifndef SIMPLIFY_INCLUDES
+#include <cstdint>
+#endif
+
+namespace zoo {
+
+/// \brief Spreads the bits of a hash over all of the bits of the result
+///
+/// The finalizer of MurmurHash3; needed by the structures that use parts
+/// of a hash since \c std::hash of integers may be the identity
+constexpr std::uint64_t mixHash(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    return h ^ (h >> 33);
+}
+
+}
+
+#endif
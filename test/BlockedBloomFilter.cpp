@@ -0,0 +1,47 @@
+#include <zoo/BlockedBloomFilter.h>
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <unordered_set>
+
+TEST_CASE("Blocked Bloom filter", "[bloom][filter]") {
+    SECTION("No false negatives, few false positives") {
+        std::vector<int> keys;
+        for(auto ndx = 0; ndx < 10000; ++ndx) { keys.push_back(ndx * 2); }
+        zoo::BlockedBloomFilter<int> filter(keys.begin(), keys.end());
+        for(auto k: keys) { REQUIRE(filter.mayContain(k)); }
+        auto falsePositives = 0;
+        for(auto ndx = 0; ndx < 10000; ++ndx) {
+            falsePositives += filter.mayContain(ndx * 2 + 1);
+        }
+        REQUIRE(falsePositives < 300);
+        REQUIRE(0 == filter.bytes() % 64);
+    }
+    SECTION("The documented rate at 10 bits per distinct key") {
+        std::mt19937 generator(1);
+        std::uniform_int_distribution<int> distribution(0, 1 << 30);
+        std::unordered_set<int> keys;
+        zoo::BlockedBloomFilter<int> filter{std::size_t(20000)};
+        while(keys.size() < 20000) {
+            auto k = distribution(generator);
+            if(keys.insert(k).second) { filter.insert(k); }
+        }
+        auto queries = 0, falsePositives = 0;
+        while(queries < 100000) {
+            auto k = distribution(generator);
+            if(keys.count(k)) { continue; }
+            ++queries;
+            falsePositives += filter.mayContain(k);
+        }
+        // about 1%
+        REQUIRE(500 < falsePositives);
+        REQUIRE(falsePositives < 1500);
+    }
+    SECTION("Empty") {
+        zoo::BlockedBloomFilter<long> filter;
+        REQUIRE(not filter.mayContain(5));
+        filter.insert(5);
+        REQUIRE(filter.mayContain(5));
+    }
+}
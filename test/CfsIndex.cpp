@@ -0,0 +1,36 @@
+#include <zoo/CfsIndex.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+
+TEST_CASE("CFS index", "[cfs][container][index]") {
+    SECTION("Empty") {
+        zoo::CfsIndex<int> index;
+        REQUIRE(0 == index.size());
+        REQUIRE(index.end() == index.lowerBound(3));
+    }
+    SECTION("Layout and searches") {
+        std::vector<int> sorted, cfs;
+        for(auto ndx = 0; ndx < 77; ++ndx) { sorted.push_back(ndx / 2 * 2); }
+        zoo::transformToCFS(back_inserter(cfs), sorted.begin(), sorted.end());
+        zoo::CfsIndex<int> index(sorted.begin(), sorted.end());
+        REQUIRE(77 == index.size());
+        // the padding slot is at the cache line boundary
+        auto padding = reinterpret_cast<std::uintptr_t>(index.begin() - 1);
+        REQUIRE(0 == padding % 64);
+        REQUIRE(std::vector<int>(index.begin(), index.end()) == cfs);
+        auto b = cfs.cbegin(), e = cfs.cend();
+        for(auto k = -1; k < 80; ++k) {
+            auto lower = zoo::cfsLowerBound(b, e, k) - b;
+            auto higher = zoo::cfsHigherBound(b, e, k) - b;
+            REQUIRE(lower == index.lowerBound(k) - index.begin());
+            REQUIRE(
+                lower ==
+                    index.lowerBound(zoo::BranchFree<4>{}, k) - index.begin()
+            );
+            REQUIRE(higher == index.higherBound(k) - index.begin());
+            REQUIRE(index.lowerBound(k) == index.equalRange(k).first);
+        }
+    }
+}
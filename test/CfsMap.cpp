@@ -0,0 +1,40 @@
+#include <zoo/CfsMap.h>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+TEST_CASE("CFS map", "[cfs][container][map]") {
+    SECTION("Keys and values are permuted alike") {
+        std::vector<int> keys;
+        std::vector<std::string> values;
+        for(auto ndx = 0; ndx < 100; ++ndx) {
+            keys.push_back(ndx * 3);
+            values.push_back(std::to_string(ndx * 3));
+        }
+        zoo::CfsMap<int, std::string> map(
+            keys.begin(), keys.end(), values.begin()
+        );
+        REQUIRE(100 == map.size());
+        for(auto ndx = 0u; ndx < map.size(); ++ndx) {
+            REQUIRE(std::to_string(map.key(ndx)) == map.value(ndx));
+        }
+        REQUIRE("42" == *map.find(42));
+        REQUIRE(nullptr == map.find(43));
+        REQUIRE(nullptr == map.find(300));
+        REQUIRE(45 == map.key(map.lowerBound(43)));
+        REQUIRE(map.size() == map.lowerBound(298));
+        *map.find(42) = "forty two";
+        REQUIRE("forty two" == *map.find(42));
+    }
+    SECTION("From unsorted pairs") {
+        zoo::CfsMap<int, char> map(
+            {{5, 'e'}, {1, 'a'}, {3, 'c'}, {2, 'b'}, {4, 'd'}}
+        );
+        REQUIRE(zoo::validHeap(map.begin(), map.end()));
+        for(auto k = 1; k <= 5; ++k) {
+            REQUIRE('a' + k - 1 == *map.find(k));
+        }
+        REQUIRE(nullptr == map.find(0));
+    }
+}
@@ -0,0 +1,58 @@
+#include <zoo/CfsSet.h>
+
+#include <catch2/catch.hpp>
+
+#include <set>
+
+TEST_CASE("CFS set", "[cfs][container][set]") {
+    std::array initial{5, 1, 9, 3, 7, 3, 11};
+    SECTION("Construction removes duplicates") {
+        zoo::CfsSet<int> s(initial.begin(), initial.end());
+        REQUIRE(6 == s.size());
+        REQUIRE(s.contains(3));
+        REQUIRE(not s.contains(4));
+    }
+    SECTION("Buffered insertions and erasures") {
+        zoo::CfsSet<int> s(initial.begin(), initial.end(), 100);
+        REQUIRE(not s.insert(5));
+        REQUIRE(s.insert(6));
+        REQUIRE(s.contains(6));
+        REQUIRE(s.erase(5));
+        REQUIRE(not s.erase(5));
+        REQUIRE(not s.contains(5));
+        REQUIRE(2 == s.pending());
+        REQUIRE(6 == *s.lowerBound(5));
+        REQUIRE(s.erase(6));
+        REQUIRE(7 == *s.lowerBound(5));
+        REQUIRE(s.insert(5));
+        REQUIRE(5 == *s.lowerBound(4));
+        REQUIRE(s.erase(11));
+        REQUIRE(nullptr == s.lowerBound(10));
+        REQUIRE(5 == s.size());
+    }
+    SECTION("Against std::set, with rebuilds") {
+        zoo::CfsSet<int> s(7);
+        std::set<int> expected;
+        auto pseudoRandom = 1u;
+        for(auto step = 0; step < 3000; ++step) {
+            pseudoRandom = pseudoRandom * 1103515245 + 12345;
+            int key = (pseudoRandom >> 8) % 200;
+            if(pseudoRandom & 0x10000) {
+                REQUIRE(expected.insert(key).second == s.insert(key));
+            } else {
+                REQUIRE(bool(expected.erase(key)) == s.erase(key));
+            }
+            REQUIRE(s.pending() <= 7);
+            auto probe = int((pseudoRandom >> 20) % 210);
+            auto lb = expected.lower_bound(probe);
+            auto found = s.lowerBound(probe);
+            if(expected.end() == lb) {
+                REQUIRE(nullptr == found);
+            } else {
+                REQUIRE(nullptr != found);
+                REQUIRE(*lb == *found);
+            }
+            REQUIRE(expected.size() == s.size());
+        }
+    }
+}
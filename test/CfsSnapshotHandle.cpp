@@ -0,0 +1,108 @@
+#include <zoo/CfsSnapshotHandle.h>
+#include <zoo/algorithm/cfs.h>
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<int> liveVersions{0};
+
+/// The keys 0, generation, 2*generation, ... in CFS order
+struct Version {
+    std::vector<int> cfs;
+    int generation;
+
+    Version(int g): generation{g} {
+        std::vector<int> sorted;
+        for(auto ndx = 0; ndx < 100; ++ndx) { sorted.push_back(ndx * g); }
+        zoo::transformToCFS(back_inserter(cfs), sorted.begin(), sorted.end());
+        ++liveVersions;
+    }
+
+    ~Version() {
+        // poisons the keys, readers of reclaimed versions would notice
+        for(auto &k: cfs) { k = -1; }
+        --liveVersions;
+    }
+
+    bool consistent() const {
+        auto e = cfs.end();
+        auto where = zoo::cfsLowerBound(cfs.begin(), e, 50 * generation);
+        return e != where && 50 * generation == *where;
+    }
+};
+
+}
+
+TEST_CASE("CFS snapshot handle", "[cfs][concurrency]") {
+    using Handle = zoo::CfsSnapshotHandle<Version>;
+    SECTION("Reclamation waits for the readers") {
+        {
+            Handle handle(2, std::make_unique<Version>(1));
+            REQUIRE(1 == liveVersions);
+            {
+                auto first = handle.acquire(0);
+                REQUIRE(1 == first->generation);
+                handle.publish(std::make_unique<Version>(2));
+                REQUIRE(2 == liveVersions);
+                REQUIRE(1 == handle.reclaim());
+                REQUIRE(first->consistent());
+                {
+                    auto second = handle.acquire(1);
+                    REQUIRE(2 == second->generation);
+                }
+                REQUIRE(1 == handle.reclaim());
+            }
+            REQUIRE(0 == handle.reclaim());
+            REQUIRE(2 == handle.acquire(0)->generation);
+            REQUIRE(1 == liveVersions);
+            handle.publish(std::make_unique<Version>(3));
+            REQUIRE(1 == liveVersions);
+        }
+        REQUIRE(0 == liveVersions);
+    }
+    SECTION("Empty") {
+        Handle handle(1);
+        REQUIRE(!handle.acquire(0));
+        handle.publish(std::make_unique<Version>(1));
+        REQUIRE(1 == handle.acquire(0)->generation);
+        REQUIRE(0 == handle.reclaim());
+    }
+    SECTION("Concurrent readers see complete versions") {
+        constexpr auto Readers = 4;
+        constexpr auto Generations = 2000;
+        {
+            Handle handle(Readers, std::make_unique<Version>(1));
+            std::atomic<bool> done{false};
+            std::atomic<int> inconsistencies{0};
+            std::vector<std::thread> readers;
+            for(auto r = 0; r < Readers; ++r) {
+                readers.emplace_back([&, r]() {
+                    auto lastSeen = 0;
+                    while(!done.load()) {
+                        auto snapshot = handle.acquire(r);
+                        auto g = snapshot->generation;
+                        if(!snapshot->consistent() || g < lastSeen) {
+                            ++inconsistencies;
+                        }
+                        lastSeen = g;
+                    }
+                });
+            }
+            for(auto g = 2; g <= Generations; ++g) {
+                handle.publish(std::make_unique<Version>(g));
+            }
+            done = true;
+            for(auto &t: readers) { t.join(); }
+            REQUIRE(0 == inconsistencies);
+            REQUIRE(0 == handle.reclaim());
+            REQUIRE(1 == liveVersions);
+        }
+        REQUIRE(0 == liveVersions);
+    }
+}
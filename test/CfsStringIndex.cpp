@@ -0,0 +1,59 @@
+#include <zoo/CfsStringIndex.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+TEST_CASE("CFS string index", "[cfs][string]") {
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<int> lengths(0, 14), characters(0, 3);
+    // few characters for long common prefixes, and the highest char
+    const char alphabet[] = {'\0', 'a', 'b', '\xff'};
+    auto randomString = [&]() {
+        std::string rv(lengths(generator), ' ');
+        for(auto &c: rv) { c = alphabet[characters(generator)]; }
+        return rv;
+    };
+    std::vector<std::string> strings;
+    for(auto ndx = 0; ndx < 2000; ++ndx) { strings.push_back(randomString()); }
+    std::sort(strings.begin(), strings.end());
+    strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+    zoo::CfsStringIndex index(strings.begin(), strings.end());
+    REQUIRE(strings.size() == index.size());
+    REQUIRE(
+        zoo::validHeap(index.begin(), index.end(), zoo::PrefixedStringLess{})
+    );
+    SECTION("Lower bounds") {
+        for(auto ndx = 0; ndx < 2000; ++ndx) {
+            auto probe = randomString();
+            auto expected =
+                std::lower_bound(strings.begin(), strings.end(), probe);
+            auto where = index.lowerBound(probe);
+            if(strings.end() == expected) {
+                REQUIRE(index.end() == where);
+            } else {
+                REQUIRE(*expected == where->view());
+            }
+            REQUIRE(
+                (strings.end() != expected && probe == *expected) ==
+                    index.contains(probe)
+            );
+            // with the comparator directly, probing with views
+            REQUIRE(
+                where ==
+                    zoo::cfsLowerBound(
+                        index.begin(), index.end(), std::string_view(probe),
+                        zoo::PrefixedStringLess{}
+                    )
+            );
+        }
+    }
+    SECTION("Copies refer to their own characters") {
+        auto copy = index;
+        index = zoo::CfsStringIndex{};
+        for(auto &s: strings) { REQUIRE(copy.contains(s)); }
+        REQUIRE(not index.contains(strings.front()));
+    }
+}
@@ -0,0 +1,165 @@
+#include <zoo/DaryHeap.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+template<typename Heap>
+std::vector<int> drain(Heap &heap) {
+    std::vector<int> rv;
+    while(!heap.empty()) {
+        rv.push_back(heap.top());
+        heap.pop();
+    }
+    return rv;
+}
+
+struct Task {
+    int key, id;
+};
+
+struct TaskLess {
+    bool operator()(const Task &l, const Task &r) const {
+        return l.key < r.key;
+    }
+};
+
+struct TaskIndex {
+    std::vector<std::size_t> *positions;
+
+    void operator()(const Task &t, std::size_t ndx) const {
+        (*positions)[t.id] = ndx;
+    }
+};
+
+template<int D>
+void checkAgainstSorting(const std::vector<int> &values) {
+    zoo::DaryHeap<int, D> pushed;
+    for(auto v: values) {
+        pushed.push(v);
+        REQUIRE(zoo::validDaryHeap<D>(pushed.begin(), pushed.end()));
+    }
+    zoo::DaryHeap<int, D> bulk(values.begin(), values.end());
+    REQUIRE(zoo::validDaryHeap<D>(bulk.begin(), bulk.end()));
+    auto sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    REQUIRE(sorted == drain(pushed));
+    REQUIRE(sorted == drain(bulk));
+}
+
+}
+
+TEST_CASE("D-ary heap", "[heap][container]") {
+    std::mt19937 generator;
+    std::uniform_int_distribution<int> distribution(-1000, 1000);
+    std::vector<int> values;
+    for(auto ndx = 0; ndx < 1000; ++ndx) {
+        values.push_back(distribution(generator));
+    }
+    SECTION("Pops in order") {
+        checkAgainstSorting<2>(values);
+        checkAgainstSorting<3>(values);
+        checkAgainstSorting<4>(values);
+        checkAgainstSorting<8>(values);
+        checkAgainstSorting<zoo::DaryHeapArity<int>>(values);
+    }
+    SECTION("Bulk insertion into a non empty heap") {
+        for(auto split: {0, 1, 5, 17, 300, 999, 1000}) {
+            zoo::DaryHeap<int> heap(values.begin(), values.begin() + split);
+            heap.heapify(values.begin() + split, values.end());
+            REQUIRE(values.size() == heap.size());
+            REQUIRE(zoo::validDaryHeap<16>(heap.begin(), heap.end()));
+        }
+    }
+    SECTION("Decrease key") {
+        zoo::DaryHeap<int, 4> heap(values.begin(), values.end());
+        for(auto repetition = 0; repetition < 200; ++repetition) {
+            auto ndx = (distribution(generator) + 1000) % heap.size();
+            auto old = *(heap.begin() + ndx);
+            auto moved = heap.decreaseKey(ndx, old - 500);
+            REQUIRE(old - 500 == *(heap.begin() + moved));
+            REQUIRE(moved <= ndx);
+            REQUIRE(zoo::validDaryHeap<4>(heap.begin(), heap.end()));
+        }
+        auto previous = heap.top();
+        while(!heap.empty()) {
+            REQUIRE(previous <= heap.top());
+            previous = heap.top();
+            heap.pop();
+        }
+    }
+    SECTION("Decrease key of tracked positions") {
+        std::vector<Task> tasks;
+        for(auto ndx = 0; ndx < 1000; ++ndx) {
+            tasks.push_back({values[ndx], ndx});
+        }
+        std::vector<std::size_t> positions(tasks.size());
+        zoo::DaryHeap<Task, 4, TaskLess, TaskIndex> heap(
+            tasks.begin(), tasks.begin() + 500, TaskLess{},
+            TaskIndex{&positions}
+        );
+        for(auto ndx = 500; ndx < 1000; ++ndx) { heap.push(tasks[ndx]); }
+        auto tracked = [&]() {
+            auto b = heap.begin();
+            for(std::size_t ndx = 0; ndx < heap.size(); ++ndx) {
+                REQUIRE(ndx == positions[(b + ndx)->id]);
+            }
+        };
+        tracked();
+        for(auto repetition = 0; repetition < 200; ++repetition) {
+            auto id = (distribution(generator) + 1000) % 1000;
+            tasks[id].key -= 500;
+            auto moved = heap.decreaseKey(positions[id], tasks[id]);
+            REQUIRE(moved == positions[id]);
+            REQUIRE(
+                zoo::validDaryHeap<4>(heap.begin(), heap.end(), TaskLess{})
+            );
+        }
+        tracked();
+        auto previous = heap.top().key;
+        while(!heap.empty()) {
+            REQUIRE(previous <= heap.top().key);
+            REQUIRE(heap.top().key == tasks[heap.top().id].key);
+            previous = heap.top().key;
+            heap.pop();
+            tracked();
+        }
+    }
+    SECTION("Comparator and larger elements") {
+        std::vector<long> longs(values.begin(), values.end());
+        zoo::DaryHeap<long, 8, std::greater<long>> heap;
+        heap.heapify(longs.begin(), longs.end());
+        std::greater<long> greater;
+        REQUIRE(zoo::validDaryHeap<8>(heap.begin(), heap.end(), greater));
+        std::sort(longs.begin(), longs.end(), greater);
+        for(auto v: longs) {
+            REQUIRE(v == heap.top());
+            heap.pop();
+        }
+    }
+    SECTION("The default arity fills lines if the elements divide them") {
+        static_assert(16 == zoo::DaryHeapArity<int>);
+        static_assert(2 == zoo::DaryHeapArity<char[32]>);
+        static_assert(4 == zoo::DaryHeapArity<char[24]>);
+        static_assert(4 == zoo::DaryHeapArity<char[12]>);
+        static_assert(4 == zoo::DaryHeapArity<char[48]>);
+    }
+    SECTION("Children groups are cache lines") {
+        zoo::DaryHeap<int> heap(values.begin(), values.end());
+        auto root = reinterpret_cast<std::uintptr_t>(heap.begin());
+        // the children of the root are the group after it
+        REQUIRE(0 == (root + sizeof(int)) % 64);
+    }
+    SECTION("Invalid heap") {
+        std::vector<int> notHeap{1, 2, 3, 0};
+        auto result = zoo::validDaryHeap<2>(notHeap.begin(), notHeap.end());
+        REQUIRE(!result);
+        REQUIRE(3 == result.failureLocation);
+    }
+}
@@ -0,0 +1,35 @@
+#include <zoo/DeduplicatedCFS.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+TEST_CASE("Deduplicated CFS", "[cfs][container][range]") {
+    SECTION("Slices of the sorted sequence") {
+        std::vector<int> sorted;
+        for(auto ndx = 0; ndx < 1000; ++ndx) { sorted.push_back(ndx / 37 * 2); }
+        zoo::DeduplicatedCFS<int> index(sorted.begin(), sorted.end());
+        REQUIRE(1000 == index.size());
+        REQUIRE(28 == index.distinct());
+        REQUIRE(zoo::validHeap(index.begin(), index.end()));
+        for(auto k = -1; k < 60; ++k) {
+            auto expected = std::equal_range(sorted.begin(), sorted.end(), k);
+            auto range = index.equalRange(k);
+            std::size_t
+                first = expected.first - sorted.begin(),
+                second = expected.second - sorted.begin();
+            REQUIRE(first == range.first);
+            REQUIRE(second == range.second);
+            REQUIRE(second - first == index.count(k));
+        }
+    }
+    SECTION("Empty") {
+        std::vector<int> none;
+        zoo::DeduplicatedCFS<int> index(none.begin(), none.end());
+        REQUIRE(0 == index.size());
+        auto range = index.equalRange(3);
+        REQUIRE(0 == range.first);
+        REQUIRE(0 == range.second);
+    }
+}
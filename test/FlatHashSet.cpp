@@ -0,0 +1,43 @@
+#include <zoo/FlatHashSet.h>
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <unordered_set>
+
+TEST_CASE("Flat hash set", "[hash][container][set]") {
+    SECTION("Agrees with the standard set") {
+        std::mt19937 generator(3);
+        std::uniform_int_distribution<int> keys(0, 5000);
+        zoo::FlatHashSet<int> set;
+        std::unordered_set<int> model;
+        for(auto ndx = 0; ndx < 100000; ++ndx) {
+            auto k = keys(generator);
+            switch(ndx % 3) {
+                case 0: REQUIRE(model.insert(k).second == set.insert(k)); break;
+                case 1: REQUIRE(bool(model.erase(k)) == set.erase(k)); break;
+                default:
+                    REQUIRE(model.count(k) == set.contains(k));
+            }
+            REQUIRE(model.size() == set.size());
+        }
+        std::unordered_set<int> iterated(set.begin(), set.end());
+        REQUIRE(model == iterated);
+        REQUIRE(set.size() < set.capacity());
+    }
+    SECTION("Find and construction from a range") {
+        std::vector<long> keys{5, 1, 5, 9, -3};
+        zoo::FlatHashSet<long> set(keys.begin(), keys.end());
+        REQUIRE(4 == set.size());
+        REQUIRE(9 == *set.find(9));
+        REQUIRE(set.end() == set.find(2));
+        REQUIRE(16 == set.capacity());
+    }
+    SECTION("Empty") {
+        zoo::FlatHashSet<int> set;
+        REQUIRE(set.empty());
+        REQUIRE(set.end() == set.find(0));
+        REQUIRE(set.begin() == set.end());
+        REQUIRE(not set.erase(0));
+    }
+}
@@ -0,0 +1,39 @@
+#include <zoo/HugePageAllocator.h>
+#include <zoo/CfsIndex.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("Huge page allocator", "[allocator][hugePage]") {
+    using A = zoo::HugePageAllocator<int>;
+    SECTION("Small allocations are cache line aligned") {
+        std::vector<int, A> small(100, 7);
+        auto address = reinterpret_cast<std::uintptr_t>(small.data());
+        REQUIRE(0 == address % 64);
+        REQUIRE(7 == small[99]);
+    }
+    SECTION("Large allocations are aligned to the huge page") {
+        auto count = 3 * A::HugePage / sizeof(int) + 5;
+        std::vector<int, A> large(count, 9);
+        auto address = reinterpret_cast<std::uintptr_t>(large.data());
+        REQUIRE(0 == address % A::HugePage);
+        REQUIRE(9 == large.back());
+    }
+    SECTION("Sizes that would overflow are rejected") {
+        A allocator;
+        REQUIRE_THROWS_AS(
+            allocator.allocate(A::max_size() + 1), std::bad_array_new_length
+        );
+        REQUIRE_THROWS_AS(
+            allocator.allocate(~std::size_t(0) / 2), std::bad_array_new_length
+        );
+    }
+    SECTION("Backing a CFS index") {
+        std::vector<int> sorted;
+        for(auto ndx = 0; ndx < 1000000; ++ndx) { sorted.push_back(ndx * 2); }
+        zoo::CfsIndex<int, zoo::Less, A> index(sorted.begin(), sorted.end());
+        REQUIRE(1000000 == *index.lowerBound(999999));
+    }
+}
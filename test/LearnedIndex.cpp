@@ -0,0 +1,53 @@
+#include <zoo/LearnedIndex.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+
+TEST_CASE("Learned index", "[learned][search]") {
+    SECTION("Matches the standard bounds") {
+        std::mt19937 generator(1);
+        for(auto distribution: {1000, 100000}) {
+            std::uniform_int_distribution<int> keyDistribution(0, distribution);
+            std::vector<int> keys(5000);
+            for(auto &k: keys) { k = keyDistribution(generator); }
+            // a cluster and long repetitions, far from linear
+            for(auto ndx = 0; ndx < 300; ++ndx) { keys.push_back(77); }
+            for(auto ndx = 0; ndx < 100; ++ndx) {
+                keys.push_back(distribution + ndx * 1000);
+            }
+            std::sort(keys.begin(), keys.end());
+            for(auto error: {0, 1, 4, 32}) {
+                zoo::LearnedIndex<int> index(keys.begin(), keys.end(), error);
+                REQUIRE(keys.size() == index.size());
+                const int *b = keys.data(), *ib = index.begin();
+                for(
+                    auto k = -2;
+                    k < distribution + 100 * 1000 + 2;
+                    k += 1 + k / 1000
+                ) {
+                    auto expected = std::equal_range(b, b + keys.size(), k);
+                    auto range = index.equalRange(k);
+                    REQUIRE(expected.first - b == index.lowerBound(k) - ib);
+                    REQUIRE(expected.first - b == range.first - ib);
+                    REQUIRE(expected.second - b == range.second - ib);
+                }
+            }
+        }
+    }
+    SECTION("Uniform keys need few segments") {
+        std::vector<long> keys;
+        for(long ndx = 0; ndx < 100000; ++ndx) { keys.push_back(ndx * 7); }
+        zoo::LearnedIndex<long> index(keys.begin(), keys.end(), 8);
+        REQUIRE(1 == index.segments());
+        REQUIRE(index.modelBytes() < keys.size());
+        REQUIRE(keys[1234] == *index.lowerBound(1234 * 7 - 3));
+    }
+    SECTION("Empty") {
+        std::vector<double> none;
+        zoo::LearnedIndex<double> index(none.begin(), none.end());
+        REQUIRE(index.end() == index.lowerBound(3.0));
+        REQUIRE(0 == index.segments());
+    }
+}
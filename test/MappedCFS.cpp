@@ -0,0 +1,106 @@
+#include <zoo/MappedCFS.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// A unique path in the temporary directory, removed on destruction
+struct TemporaryPath {
+    std::string path;
+
+    TemporaryPath() {
+        auto directory = std::getenv("TMPDIR");
+        path = std::string(directory ? directory : "/tmp") + "/zooCFSXXXXXX";
+        auto fd = ::mkstemp(&path[0]);
+        if(fd < 0) { zoo::detail::throwSystemError("temporary CFS file"); }
+        ::close(fd);
+    }
+
+    ~TemporaryPath() { std::remove(path.c_str()); }
+
+    const char *c_str() const noexcept { return path.c_str(); }
+};
+
+/// The header followed by \c padding zero bytes
+void writeHeader(
+    const char *path, const zoo::CfsFileHeader &header,
+    std::size_t padding = 0
+) {
+    auto file = std::fopen(path, "wb");
+    REQUIRE(file);
+    REQUIRE(1 == std::fwrite(&header, sizeof(header), 1, file));
+    std::vector<char> zeros(padding);
+    REQUIRE(padding == std::fwrite(zeros.data(), 1, padding, file));
+    REQUIRE(0 == std::fclose(file));
+}
+
+}
+
+TEST_CASE("Memory mapped CFS file", "[cfs][file][mmap]") {
+    TemporaryPath temporary;
+    auto path = temporary.c_str();
+    std::vector<int> sorted, cfs;
+    for(auto ndx = 0; ndx < 1000; ++ndx) { sorted.push_back(ndx * 2); }
+    zoo::transformToCFS(back_inserter(cfs), sorted.begin(), sorted.end());
+    zoo::writeCFSFile(path, sorted.begin(), sorted.end(), 77);
+    SECTION("The payload is the CFS layout, searchable in place") {
+        zoo::MappedCFS<int> mapped(path, 77);
+        REQUIRE(1000u == mapped.size());
+        REQUIRE(0 == reinterpret_cast<std::uintptr_t>(mapped.begin()) % 64);
+        REQUIRE(std::vector<int>(mapped.begin(), mapped.end()) == cfs);
+        auto b = mapped.begin(), e = mapped.end();
+        REQUIRE(500 == *zoo::cfsLowerBound(b, e, 499));
+        REQUIRE(e == zoo::cfsLowerBound(b, e, 1999));
+        auto moved = std::move(mapped);
+        REQUIRE(b == moved.begin());
+    }
+    SECTION("Mismatches are rejected") {
+        REQUIRE_THROWS(zoo::MappedCFS<int>(path, 78));
+        REQUIRE_THROWS(zoo::MappedCFS<long long>(path, 77));
+        REQUIRE_THROWS(zoo::MappedCFS<int>("zooMappedCFSTest.missing"));
+    }
+    SECTION("Corrupt headers are rejected") {
+        zoo::CfsFileHeader valid{
+            zoo::CfsFileHeader::Magic, zoo::CfsFileHeader::CurrentVersion,
+            sizeof(int), 0, 77, 64, 64
+        };
+        auto rejects = [&](
+            zoo::CfsFileHeader header, const char *reason,
+            std::size_t padding = 64
+        ) {
+            writeHeader(path, header, padding);
+            REQUIRE_THROWS_WITH(
+                zoo::MappedCFS<int>(path, 77), Catch::Contains(reason)
+            );
+        };
+        auto pastEnd = valid;
+        pastEnd.payloadOffset = 4096;
+        rejects(pastEnd, "out of bounds");
+        rejects(valid, "out of bounds", 0);
+        auto insideHeader = valid;
+        insideHeader.payloadOffset = 8;
+        insideHeader.alignment = 8;
+        rejects(insideHeader, "out of bounds");
+        auto noAlignment = valid;
+        noAlignment.alignment = 0;
+        rejects(noAlignment, "misaligned");
+        auto notPowerOfTwo = valid;
+        notPowerOfTwo.alignment = 12;
+        rejects(notPowerOfTwo, "misaligned");
+        auto lessThanElement = valid;
+        lessThanElement.alignment = 2;
+        rejects(lessThanElement, "misaligned");
+        auto notDividing = valid;
+        notDividing.alignment = 128;
+        rejects(notDividing, "misaligned");
+        // the payload begins within the file, but holds 10 of 1000 ints
+        auto truncated = valid;
+        truncated.count = 1000;
+        rejects(truncated, "truncated");
+    }
+}
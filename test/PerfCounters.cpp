@@ -0,0 +1,48 @@
+#include "cfs/perf_counters.h"
+
+#include <catch2/catch.hpp>
+
+#include <cerrno>
+
+TEST_CASE("Scaling of multiplexed counts", "[benchmark][perf]") {
+    SECTION("Counts of events that always ran are exact") {
+        REQUIRE(0 == scaledCount(0, 100, 100));
+        REQUIRE(12345 == scaledCount(12345, 100, 100));
+        REQUIRE(12345 == scaledCount(12345, 99, 100));
+    }
+    SECTION("Counts of events that shared the PMU are extrapolated") {
+        REQUIRE(2000 == scaledCount(1000, 100, 50));
+        REQUIRE(3000 == scaledCount(1000, 300, 100));
+        REQUIRE(0 == scaledCount(0, 300, 100));
+    }
+    SECTION("Events that never ran count nothing") {
+        REQUIRE(0 == scaledCount(1000, 100, 0));
+        REQUIRE(0 == scaledCount(0, 0, 0));
+    }
+}
+
+TEST_CASE("Unavailable perf counters", "[benchmark][perf]") {
+    auto check = [](const PerfCounters &counters) {
+        for(auto e = 0; e < PerfCounters::EventCount; ++e) {
+            auto event = PerfCounters::Event(e);
+            if(!counters.valid(event)) { REQUIRE(0 == counters.read(event)); }
+        }
+    };
+    SECTION("Counters that fail to open are not valid and read 0") {
+        // as perf_event_open does when perf_event_paranoid forbids it
+        PerfCounters counters([](std::uint64_t) {
+            errno = EACCES;
+            return -1;
+        });
+        REQUIRE(!counters.anyValid());
+        counters.start();
+        counters.stop();
+        check(counters);
+    }
+    SECTION("The counters of the system, whichever are available") {
+        PerfCounters counters;
+        counters.start();
+        counters.stop();
+        check(counters);
+    }
+}
@@ -1,4 +1,5 @@
 #include <zoo/algorithm/cfs.h>
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <zoo/util/container_insertion.h>
@@ -240,6 +241,21 @@ TEST_CASE(
         REQUIRE(eq(*eights.first, raw[6]));
         REQUIRE(eights.second == e);
     }
+    SECTION("Streaks longer than the height") {
+        for(auto size = 1; size < 200; ++size) {
+            std::vector<int> sorted, cfs;
+            for(auto ndx = 0; ndx < size; ++ndx) { sorted.push_back(ndx / 9); }
+            zoo::transformToCFS(
+                back_inserter(cfs), sorted.begin(), sorted.end()
+            );
+            auto b{cbegin(cfs)}, e{cend(cfs)};
+            for(auto k = -1; k <= size / 9 + 1; ++k) {
+                auto range = zoo::cfsEqualRange(b, e, k);
+                REQUIRE(zoo::cfsLowerBound(b, e, k) == range.first);
+                REQUIRE(zoo::cfsHigherBound(b, e, k) == range.second);
+            }
+        }
+    }
     SECTION("CFS with repetitions") {
         std::array hasRepetitions{1, 4, 4, 6, 8, 8, 10};
                                 /*0  1  2  3  4  5  6
@@ -299,3 +315,208 @@ TEST_CASE(
         }
     }
 }
+
+TEST_CASE("Cache friendly search batches", "[cfs][search][batch]") {
+    std::array hasRepetitions{1, 4, 4, 6, 8, 8, 8, 10, 11, 13, 13, 20};
+    std::vector<int> cfs;
+    zoo::transformToCFS(
+        back_inserter(cfs), hasRepetitions.begin(), hasRepetitions.end()
+    );
+    auto b{cbegin(cfs)}, e{cend(cfs)};
+    std::vector<int> keys;
+    for(auto k = -1; k < 23; ++k) { keys.push_back(k); }
+    using I = decltype(b);
+    SECTION("Empty space") {
+        std::vector<I> results;
+        zoo::cfsLowerBoundBatch(
+            b, b, keys.begin(), keys.end(), back_inserter(results)
+        );
+        REQUIRE(keys.size() == results.size());
+        for(auto r: results) { REQUIRE(b == r); }
+    }
+    SECTION("Lower bounds, groups of 5 don't divide the keys") {
+        std::vector<I> results;
+        zoo::cfsLowerBoundBatch<5>(
+            b, e, keys.begin(), keys.end(), back_inserter(results)
+        );
+        REQUIRE(keys.size() == results.size());
+        for(auto ndx = 0u; ndx < keys.size(); ++ndx) {
+            REQUIRE(zoo::cfsLowerBound(b, e, keys[ndx]) == results[ndx]);
+        }
+    }
+    SECTION("Higher bounds") {
+        std::vector<I> results;
+        zoo::cfsHigherBoundBatch(
+            b, e, keys.begin(), keys.end(), back_inserter(results)
+        );
+        REQUIRE(keys.size() == results.size());
+        for(auto ndx = 0u; ndx < keys.size(); ++ndx) {
+            REQUIRE(zoo::cfsHigherBound(b, e, keys[ndx]) == results[ndx]);
+        }
+    }
+    SECTION("Equal ranges") {
+        std::vector<std::pair<I, I>> results;
+        zoo::cfsEqualRangeBatch<3>(
+            b, e, keys.begin(), keys.end(), back_inserter(results)
+        );
+        REQUIRE(keys.size() == results.size());
+        for(auto ndx = 0u; ndx < keys.size(); ++ndx) {
+            REQUIRE(zoo::cfsEqualRange(b, e, keys[ndx]) == results[ndx]);
+        }
+    }
+}
+
+TEST_CASE("Branch free cache friendly search", "[cfs][search][branchFree]") {
+    // sizes straddle complete levels, the values have repetitions
+    for(auto size = 0; size < 40; ++size) {
+        std::vector<int> sorted, cfs;
+        for(auto ndx = 0; ndx < size; ++ndx) { sorted.push_back(ndx / 3 * 2); }
+        zoo::transformToCFS(back_inserter(cfs), sorted.begin(), sorted.end());
+        auto b{cbegin(cfs)}, e{cend(cfs)};
+        for(auto k = -1; k <= size; ++k) {
+            auto lower = zoo::cfsLowerBound(b, e, k);
+            auto higher = zoo::cfsHigherBound(b, e, k);
+            REQUIRE(lower == zoo::cfsLowerBound(zoo::BranchFree<>{}, b, e, k));
+            REQUIRE(lower == zoo::cfsLowerBound(zoo::BranchFree<0>{}, b, e, k));
+            REQUIRE(lower == zoo::cfsLowerBound(zoo::Branching{}, b, e, k));
+            REQUIRE(
+                higher == zoo::cfsHigherBound(zoo::BranchFree<2>{}, b, e, k)
+            );
+        }
+    }
+}
+
+TEST_CASE("In-place conversion to CFS", "[cfs][conversion][inPlace]") {
+    for(auto size = 0; size < 70; ++size) {
+        std::vector<int> inPlace, copied;
+        for(auto ndx = 0; ndx < size; ++ndx) { inPlace.push_back(ndx); }
+        zoo::transformToCFS(
+            back_inserter(copied), inPlace.cbegin(), inPlace.cend()
+        );
+        zoo::transformToCFSInPlace(inPlace.begin(), inPlace.end());
+        REQUIRE(copied == inPlace);
+    }
+}
+
+TEST_CASE("Sorting into CFS", "[cfs][conversion][sort]") {
+    for(auto size: {0, 1, 2, 3, 10, 16, 17, 40, 100, 1000}) {
+        std::vector<int> unsorted, expected;
+        // a permutation with repetitions
+        for(auto ndx = 0; ndx < size; ++ndx) {
+            unsorted.push_back(ndx * 37 % 101 / 2);
+        }
+        auto sorted = unsorted;
+        std::sort(sorted.begin(), sorted.end());
+        zoo::transformToCFS(
+            back_inserter(expected), sorted.cbegin(), sorted.cend()
+        );
+        std::vector<int> output(size);
+        zoo::sortToCFS(unsorted.begin(), unsorted.end(), output.begin());
+        REQUIRE(expected == output);
+        REQUIRE(sorted == unsorted);
+    }
+    SECTION("Already sorted, all equivalent") {
+        std::vector<int> sorted, equivalent(1000, 5), expected;
+        for(auto ndx = 0; ndx < 1000; ++ndx) { sorted.push_back(ndx); }
+        zoo::transformToCFS(
+            back_inserter(expected), sorted.cbegin(), sorted.cend()
+        );
+        std::vector<int> output(1000);
+        zoo::sortToCFS(sorted.begin(), sorted.end(), output.begin());
+        REQUIRE(expected == output);
+        zoo::sortToCFS(equivalent.begin(), equivalent.end(), output.begin());
+        REQUIRE(std::vector<int>(1000, 5) == output);
+    }
+}
+
+TEST_CASE("Cache friendly search in order", "[cfs][inorder][rank]") {
+    std::array sorted{1, 4, 4, 6, 8, 8, 8, 10, 11, 13, 13, 20};
+    std::vector<int> cfs;
+    zoo::transformToCFS(back_inserter(cfs), sorted.begin(), sorted.end());
+    auto b{cbegin(cfs)}, e{cend(cfs)};
+    SECTION("Rank and select") {
+        for(auto ndx = 0u; ndx < sorted.size(); ++ndx) {
+            auto where = zoo::cfsSelect(b, e, ndx);
+            REQUIRE(sorted[ndx] == *where);
+            REQUIRE(ndx == zoo::cfsRank(b, e, where));
+        }
+        REQUIRE(e == zoo::cfsSelect(b, e, sorted.size()));
+        REQUIRE(sorted.size() == zoo::cfsRank(b, e, e));
+    }
+    SECTION("Counts of ranges") {
+        for(auto lo = 0; lo < 22; ++lo) {
+            for(auto hi = 0; hi < 22; ++hi) {
+                std::size_t expected =
+                    std::count_if(
+                        sorted.begin(), sorted.end(),
+                        [=](int v) { return lo <= v && v < hi; }
+                    );
+                REQUIRE(expected == zoo::cfsCount(b, e, lo, hi));
+            }
+        }
+    }
+    SECTION("Traversal both ways") {
+        std::vector<int> forward(
+            zoo::cfsInorderBegin(b, e), zoo::cfsInorderEnd(b, e)
+        );
+        REQUIRE(sorted == forward);
+        std::vector<int> backward;
+        auto first = zoo::cfsInorderBegin(b, e);
+        for(auto i = zoo::cfsInorderEnd(b, e); first != i; ) {
+            backward.push_back(*--i);
+        }
+        REQUIRE(std::vector<int>(sorted.rbegin(), sorted.rend()) == backward);
+    }
+    SECTION("Walking the equal range") {
+        auto lower = zoo::cfsInorder(b, e, zoo::cfsLowerBound(b, e, 8));
+        auto higher = zoo::cfsInorder(b, e, zoo::cfsHigherBound(b, e, 8));
+        REQUIRE(3 == std::distance(lower, higher));
+        for(; lower != higher; ++lower) { REQUIRE(8 == *lower); }
+        REQUIRE(10 == *higher);
+        REQUIRE(zoo::cfsHigherBound(b, e, 8) == higher.layout());
+    }
+}
+
+namespace {
+
+template<std::size_t Size>
+constexpr auto evens() {
+    std::array<int, Size> rv{};
+    for(auto ndx = 0u; ndx < Size; ++ndx) { rv[ndx] = 2 * ndx; }
+    return rv;
+}
+
+constexpr auto SmallTable = zoo::makeCFS(std::array{1, 3, 5, 7, 9, 11, 13});
+static_assert(7 == SmallTable[0] && 3 == SmallTable[1] && 13 == SmallTable[6]);
+static_assert(
+    9 == *zoo::cfsLowerBound(SmallTable.begin(), SmallTable.end(), 8)
+);
+static_assert(
+    SmallTable.end() ==
+        zoo::cfsHigherBound(SmallTable.begin(), SmallTable.end(), 13)
+);
+
+constexpr auto LargeTable = zoo::makeCFS(evens<1000>());
+static_assert(
+    1000 == *zoo::cfsLowerBound(LargeTable.begin(), LargeTable.end(), 999)
+);
+static_assert(
+    500 ==
+        zoo::cfsRank(
+            LargeTable.begin(), LargeTable.end(),
+            zoo::cfsLowerBound(LargeTable.begin(), LargeTable.end(), 1000)
+        )
+);
+
+}
+
+TEST_CASE("Cache friendly search at compile time", "[cfs][constexpr]") {
+    auto b = LargeTable.begin(), e = LargeTable.end();
+    REQUIRE(zoo::validHeap(b, e));
+    for(auto k = -1; k < 2001; ++k) {
+        auto where = zoo::cfsLowerBound(b, e, k);
+        REQUIRE(std::size_t(k + 1) / 2 == zoo::cfsRank(b, e, where));
+    }
+    constexpr auto empty = zoo::makeCFS(std::array<int, 0>{});
+    REQUIRE(empty.end() == zoo::cfsLowerBound(empty.begin(), empty.end(), 0));
+}
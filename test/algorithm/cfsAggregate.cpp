@@ -0,0 +1,40 @@
+#include <zoo/algorithm/cfsAggregate.h>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+TEST_CASE("Aggregates of ranges of CFS", "[cfs][aggregate]") {
+    for(auto size: {0, 1, 2, 7, 12, 100, 257}) {
+        std::vector<int> sorted, values;
+        for(auto ndx = 0; ndx < size; ++ndx) {
+            sorted.push_back(ndx / 3);
+            values.push_back((ndx * 37) % 101 - 50);
+        }
+        std::vector<int> keys, cfsValues;
+        zoo::transformToCFS(back_inserter(keys), sorted.begin(), sorted.end());
+        zoo::transformToCFS(
+            back_inserter(cfsValues), values.begin(), values.end()
+        );
+        std::vector<int> sums(size), minima(size);
+        auto vb = cfsValues.begin(), ve = cfsValues.end();
+        zoo::cfsSubtreeAggregates(vb, ve, sums.begin(), std::plus<int>{});
+        zoo::cfsSubtreeAggregates(vb, ve, minima.begin(), zoo::Minimum{});
+        auto b = keys.cbegin(), e = keys.cend();
+        for(auto lo = -1; lo <= size / 3 + 1; ++lo) {
+            for(auto hi = -1; hi <= size / 3 + 2; ++hi) {
+                auto sum = 0, minimum = std::numeric_limits<int>::max();
+                for(auto ndx = 0; ndx < size; ++ndx) {
+                    if(lo <= sorted[ndx] && sorted[ndx] < hi) {
+                        sum += values[ndx];
+                        minimum = std::min(minimum, values[ndx]);
+                    }
+                }
+                REQUIRE(sum == zoo::cfsSum(b, e, vb, sums.begin(), lo, hi));
+                REQUIRE(
+                    minimum == zoo::cfsMin(b, e, vb, minima.begin(), lo, hi)
+                );
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include <zoo/algorithm/cfsColumns.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("CFS over columns", "[cfs][search][columns]") {
+    std::mt19937 generator;
+    std::uniform_int_distribution<int> tenants(0, 20), times(0, 1000);
+    std::vector<std::tuple<int, long, char>> rows;
+    for(auto ndx = 0; ndx < 777; ++ndx) {
+        auto tenant = tenants(generator);
+        rows.emplace_back(tenant, times(generator), 'a' + ndx % 26);
+    }
+    std::sort(rows.begin(), rows.end());
+    std::vector<int> sortedTenants;
+    std::vector<long> sortedTimes;
+    std::vector<char> sortedPayloads;
+    for(auto &[tenant, time, payload]: rows) {
+        sortedTenants.push_back(tenant);
+        sortedTimes.push_back(time);
+        sortedPayloads.push_back(payload);
+    }
+    auto size = rows.size();
+    std::vector<int> tenantColumn(size);
+    std::vector<long> timeColumn(size);
+    std::vector<char> payloadColumn(size);
+    zoo::transformColumnsToCFS(
+        std::make_tuple(
+            tenantColumn.begin(), timeColumn.begin(), payloadColumn.begin()
+        ),
+        std::make_tuple(
+            sortedTenants.cbegin(), sortedTimes.cbegin(),
+            sortedPayloads.cbegin()
+        ),
+        size
+    );
+    REQUIRE(zoo::validHeap(tenantColumn.begin(), tenantColumn.end()));
+    auto columns =
+        std::make_tuple(
+            tenantColumn.cbegin(), timeColumn.cbegin(), payloadColumn.cbegin()
+        );
+
+    SECTION("Rows are permuted alike") {
+        for(std::size_t ndx = 0; ndx < size; ++ndx) {
+            auto sorted = zoo::detail::cfsSortedIndex(size, ndx);
+            REQUIRE(rows[sorted] == std::make_tuple(
+                tenantColumn[ndx], timeColumn[ndx], payloadColumn[ndx]
+            ));
+        }
+    }
+    SECTION("Lower bound of pairs of keys") {
+        for(auto tenant = -1; tenant <= 21; ++tenant) {
+            for(long time = -1; time <= 1001; time += 7) {
+                auto expected =
+                    std::lower_bound(
+                        rows.begin(), rows.end(), std::make_pair(tenant, time),
+                        [](auto &row, auto &keys) {
+                            auto &[rowTenant, rowTime, payload] = row;
+                            return std::make_pair(rowTenant, rowTime) < keys;
+                        }
+                    );
+                auto found =
+                    zoo::cfsLowerBound(
+                        columns, size, std::make_tuple(tenant, time)
+                    );
+                if(rows.end() == expected) {
+                    REQUIRE(size == found);
+                } else {
+                    REQUIRE(size != found);
+                    auto sorted = zoo::detail::cfsSortedIndex(size, found);
+                    REQUIRE(std::size_t(expected - rows.begin()) == sorted);
+                }
+            }
+        }
+    }
+    SECTION("Leading column only") {
+        for(auto tenant = -1; tenant <= 21; ++tenant) {
+            std::size_t expected =
+                std::lower_bound(
+                    sortedTenants.begin(), sortedTenants.end(), tenant
+                ) - sortedTenants.begin();
+            auto found =
+                zoo::cfsLowerBound(columns, size, std::make_tuple(tenant));
+            if(expected == sortedTenants.size()) {
+                REQUIRE(size == found);
+            } else {
+                auto sorted = zoo::detail::cfsSortedIndex(size, found);
+                REQUIRE(expected == sorted);
+            }
+        }
+    }
+    SECTION("Comparator") {
+        std::vector<int> descending{9, 9, 7, 7, 7, 2}, first(6);
+        std::vector<int> ties{3, 1, 5, 4, 0, 8}, second(6);
+        zoo::transformColumnsToCFS(
+            std::make_tuple(first.begin(), second.begin()),
+            std::make_tuple(descending.cbegin(), ties.cbegin()), 6
+        );
+        auto found =
+            zoo::cfsLowerBound(
+                std::make_tuple(first.cbegin(), second.cbegin()), 6,
+                std::make_tuple(7, 2), std::greater<int>{}
+            );
+        // in descending order, (7, 2) goes between (7, 4) and (7, 0)
+        REQUIRE(4 == zoo::detail::cfsSortedIndex(6, found));
+    }
+}
@@ -0,0 +1,34 @@
+#include <zoo/algorithm/cfsParallel.h>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+TEST_CASE("Sorted and layout indices", "[cfs][conversion][index]") {
+    for(auto size = 1u; size < 70; ++size) {
+        std::vector<std::size_t> sorted, cfs;
+        for(auto ndx = 0u; ndx < size; ++ndx) { sorted.push_back(ndx); }
+        zoo::transformToCFS(back_inserter(cfs), sorted.begin(), sorted.end());
+        for(auto ndx = 0u; ndx < size; ++ndx) {
+            REQUIRE(cfs[ndx] == zoo::detail::cfsSortedIndex(size, ndx));
+            REQUIRE(ndx == zoo::detail::cfsLayoutIndex(size, cfs[ndx]));
+        }
+    }
+}
+
+TEST_CASE("Parallel conversion to CFS", "[cfs][conversion][parallel]") {
+    for(auto size: {0, 1, 2, 3, 10, 12, 1000, 4097}) {
+        std::vector<int> sorted, expected;
+        for(auto ndx = 0; ndx < size; ++ndx) { sorted.push_back(ndx / 2); }
+        zoo::transformToCFS(
+            back_inserter(expected), sorted.begin(), sorted.end()
+        );
+        for(auto threads: {0u, 1u, 3u, 8u}) {
+            std::vector<int> output(size);
+            zoo::transformToCFSParallel(
+                output.begin(), sorted.cbegin(), sorted.cend(), threads
+            );
+            REQUIRE(expected == output);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <zoo/algorithm/cfsSetOperations.h>
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<int> randomSorted(std::mt19937 &g, int size, int maximum) {
+    std::uniform_int_distribution<int> keys(0, maximum);
+    std::vector<int> rv(size);
+    for(auto &k: rv) { k = keys(g); }
+    std::sort(rv.begin(), rv.end());
+    return rv;
+}
+
+std::vector<int> toCFS(const std::vector<int> &sorted) {
+    std::vector<int> rv;
+    zoo::transformToCFS(back_inserter(rv), sorted.begin(), sorted.end());
+    return rv;
+}
+
+}
+
+TEST_CASE("Set operations of CFS arrays", "[cfs][set]") {
+    std::mt19937 generator(7);
+    // balanced sizes stream, the lopsided search the larger
+    std::pair<int, int> sizes[] = {
+        {0, 0}, {0, 10}, {10, 0}, {100, 120}, {1000, 1000},
+        {5, 2000}, {2000, 5}, {1, 1000}, {1000, 1}
+    };
+    for(auto maximum: {50, 5000}) {
+        for(auto [size1, size2]: sizes) {
+            auto sorted1 = randomSorted(generator, size1, maximum);
+            auto sorted2 = randomSorted(generator, size2, maximum);
+            auto cfs1 = toCFS(sorted1), cfs2 = toCFS(sorted2);
+            auto b1 = cfs1.cbegin(), e1 = cfs1.cend();
+            auto b2 = cfs2.cbegin(), e2 = cfs2.cend();
+            std::vector<int> expected, result;
+            std::set_intersection(
+                sorted1.begin(), sorted1.end(), sorted2.begin(), sorted2.end(),
+                back_inserter(expected)
+            );
+            zoo::cfsIntersect(b1, e1, b2, e2, back_inserter(result));
+            REQUIRE(expected == result);
+            expected.clear();
+            result.clear();
+            std::set_union(
+                sorted1.begin(), sorted1.end(), sorted2.begin(), sorted2.end(),
+                back_inserter(expected)
+            );
+            zoo::cfsUnion(b1, e1, b2, e2, back_inserter(result));
+            REQUIRE(expected == result);
+            expected.clear();
+            result.clear();
+            std::set_difference(
+                sorted1.begin(), sorted1.end(), sorted2.begin(), sorted2.end(),
+                back_inserter(expected)
+            );
+            zoo::cfsDifference(b1, e1, b2, e2, back_inserter(result));
+            REQUIRE(expected == result);
+        }
+    }
+}
+
+TEST_CASE("SIMD intersection of CFS arrays", "[cfs][set][simd]") {
+    std::mt19937 generator(11);
+    for(auto [size1, size2]: {
+        std::pair{0, 5}, {3, 3}, {100, 7}, {1000, 1500}, {3000, 2000}
+    }) {
+        auto sorted1 = randomSorted(generator, size1, 5000);
+        auto sorted2 = randomSorted(generator, size2, 5000);
+        for(auto sorted: {&sorted1, &sorted2}) {
+            auto unique = std::unique(sorted->begin(), sorted->end());
+            sorted->erase(unique, sorted->end());
+        }
+        auto cfs1 = toCFS(sorted1), cfs2 = toCFS(sorted2);
+        std::vector<int> expected, result;
+        std::set_intersection(
+            sorted1.begin(), sorted1.end(), sorted2.begin(), sorted2.end(),
+            back_inserter(expected)
+        );
+        zoo::cfsIntersect(
+            zoo::SimdMerge{}, cfs1.cbegin(), cfs1.cend(),
+            cfs2.cbegin(), cfs2.cend(), back_inserter(result)
+        );
+        REQUIRE(expected == result);
+    }
+}
@@ -0,0 +1,60 @@
+#include <zoo/algorithm/karyCFS.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+template<int B, typename T>
+void checkAgainstSorted(const std::vector<T> &sorted, int keyLimit) {
+    constexpr auto KeysPerNode = zoo::KaryKeysPerNode<T, B>;
+    std::vector<T> kary(zoo::karyCFSSize<KeysPerNode>(sorted.size()));
+    zoo::transformToKaryCFS<B>(kary.begin(), sorted.cbegin(), sorted.cend());
+    auto b{kary.cbegin()}, e{kary.cend()};
+    for(auto k = -1; k <= keyLimit; ++k) {
+        auto expected = std::lower_bound(sorted.begin(), sorted.end(), T(k));
+        auto found = zoo::karyLowerBound<B>(b, e, T(k));
+        if(sorted.end() == expected) {
+            REQUIRE(e == found);
+        } else {
+            REQUIRE(e != found);
+            REQUIRE(*expected == *found);
+        }
+    }
+}
+
+TEST_CASE("K-ary cache friendly search", "[cfs][kary][search]") {
+    SECTION("Layout") {
+        // 3 keys per node, 4 children; 9 keys need 3 nodes
+        std::vector<int> sorted{0, 1, 2, 3, 4, 5, 6, 7, 8}, kary(9);
+        zoo::transformToKaryCFS<3>(kary.begin(), sorted.cbegin(), sorted.cend());
+        /* root: [3 7 8]
+           children: [0 1 2] [4 5 6] */
+        REQUIRE(std::vector<int>{3, 7, 8, 0, 1, 2, 4, 5, 6} == kary);
+    }
+    SECTION("Padding") {
+        std::vector<int> sorted{0, 1, 2, 3}, kary(zoo::karyCFSSize<3>(4));
+        REQUIRE(6 == kary.size());
+        zoo::transformToKaryCFS<3>(kary.begin(), sorted.cbegin(), sorted.cend());
+        REQUIRE(std::vector<int>{3, 3, 3, 0, 1, 2} == kary);
+        auto b{kary.cbegin()}, e{kary.cend()};
+        REQUIRE(b == zoo::karyLowerBound<3>(b, e, 3));
+        REQUIRE(e == zoo::karyLowerBound<3>(b, e, 4));
+    }
+    SECTION("Against std::lower_bound, with repetitions") {
+        for(auto size = 0; size < 300; size += 7) {
+            std::vector<int> sorted;
+            for(auto ndx = 0; ndx < size; ++ndx) {
+                sorted.push_back(ndx / 2 * 3);
+            }
+            auto keyLimit = size * 3 / 2 + 2;
+            checkAgainstSorted<2>(sorted, keyLimit);
+            checkAgainstSorted<5>(sorted, keyLimit);
+            // the cache line nodes, ranked with SIMD
+            checkAgainstSorted<16>(sorted, keyLimit);
+            checkAgainstSorted<0>(sorted, keyLimit);
+            std::vector<long> wide(sorted.begin(), sorted.end());
+            checkAgainstSorted<0>(wide, keyLimit);
+        }
+    }
+}
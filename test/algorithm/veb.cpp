@@ -0,0 +1,79 @@
+#include <zoo/algorithm/veb.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace {
+
+template<typename Comparator = zoo::Less>
+void checkAgainstSorted(
+    const std::vector<int> &sorted, int keyLimit, Comparator c = Comparator{}
+) {
+    std::vector<int> veb(zoo::vebSize(sorted.size()));
+    zoo::transformToVEB(veb.begin(), sorted.cbegin(), sorted.cend());
+    auto b{veb.cbegin()}, e{veb.cend()};
+    for(auto k = -1; k <= keyLimit; ++k) {
+        auto expected = std::lower_bound(sorted.begin(), sorted.end(), k, c);
+        auto found = zoo::vebLowerBound(b, e, k, c);
+        if(sorted.end() == expected) {
+            REQUIRE(e == found);
+        } else {
+            REQUIRE(e != found);
+            REQUIRE(*expected == *found);
+        }
+    }
+}
+
+}
+
+TEST_CASE("Van Emde Boas layout", "[veb][search]") {
+    SECTION("Sizes") {
+        static_assert(0 == zoo::vebSize(0));
+        static_assert(1 == zoo::vebSize(1));
+        static_assert(3 == zoo::vebSize(2));
+        static_assert(7 == zoo::vebSize(7));
+        static_assert(15 == zoo::vebSize(8));
+    }
+    SECTION("Layout") {
+        std::vector<int> sorted(15), veb(15);
+        for(auto ndx = 0; ndx < 15; ++ndx) { sorted[ndx] = ndx; }
+        zoo::transformToVEB(veb.begin(), sorted.cbegin(), sorted.cend());
+        // a top tree of height 2, then its four bottom trees of height 2
+        std::vector<int> expected{
+            7, 3, 11, 1, 0, 2, 5, 4, 6, 9, 8, 10, 13, 12, 14
+        };
+        REQUIRE(expected == veb);
+        // height 3: the top is the root, the bottoms the subtrees
+        std::vector<int> smaller(7);
+        zoo::transformToVEB(
+            smaller.begin(), sorted.cbegin(), sorted.cend() - 8
+        );
+        REQUIRE(std::vector<int>{3, 1, 0, 2, 5, 4, 6} == smaller);
+    }
+    SECTION("Padding with the maximum") {
+        std::vector<int> sorted{1, 3, 5, 7, 9}, veb(zoo::vebSize(5));
+        zoo::transformToVEB(veb.begin(), sorted.cbegin(), sorted.cend());
+        // in order the keys are 1, 3, 5, 7, 9 and then two paddings, the
+        // parent of the input 9 is a padding
+        REQUIRE(std::vector<int>{7, 3, 1, 5, 9, 9, 9} == veb);
+        auto found = zoo::vebLowerBound(veb.cbegin(), veb.cend(), 9);
+        REQUIRE(veb.cbegin() + 5 == found);
+    }
+    SECTION("Lower bound against the sorted sequence") {
+        for(auto size = 0; size < 140; ++size) {
+            std::vector<int> sorted;
+            for(auto ndx = 0; ndx < size; ++ndx) {
+                sorted.push_back(ndx / 3 * 2);
+            }
+            checkAgainstSorted(sorted, 2 * size / 3 + 2);
+        }
+    }
+    SECTION("Comparator") {
+        std::vector<int> sorted;
+        for(auto ndx = 300; ndx--; ) { sorted.push_back(ndx / 2); }
+        checkAgainstSorted(sorted, 152, std::greater<int>{});
+    }
+}